@@ -318,6 +318,8 @@ add_option(TIMEMORY_USE_DEPRECATED
     "Enable deprecated code" OFF CMAKE_DEFINE)
 add_option(TIMEMORY_USE_STATISTICS
     "Enable statistics by default" ON CMAKE_DEFINE)
+add_option(TIMEMORY_USE_FNV1A_HASH
+    "Use FNV-1a instead of wyhash for the hash of the region labels" OFF CMAKE_DEFINE)
 add_option(TIMEMORY_USE_MPI
     "Enable MPI usage" ${_MPI} CMAKE_DEFINE)
 add_option(TIMEMORY_USE_MPI_INIT
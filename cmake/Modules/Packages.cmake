@@ -492,6 +492,17 @@ if(TIMEMORY_USE_DEPRECATED)
     timemory_target_compile_definitions(timemory-headers INTERFACE TIMEMORY_USE_DEPRECATED)
 endif()
 
+#----------------------------------------------------------------------------------------#
+#
+#                           Hash algorithm
+#
+#----------------------------------------------------------------------------------------#
+
+
+if(TIMEMORY_USE_FNV1A_HASH)
+    timemory_target_compile_definitions(timemory-headers INTERFACE TIMEMORY_USE_FNV1A_HASH)
+endif()
+
 #----------------------------------------------------------------------------------------#
 #
 #                           Cereal (serialization library)
@@ -58,6 +58,10 @@ struct basic_pointer
 {};
 struct blank_pointer
 {};
+struct string_key
+{};
+struct static_hash
+{};
 struct measure
 {};
 }  // namespace mode
@@ -183,13 +187,49 @@ fibonacci(int64_t n, int64_t cutoff)
 
 //======================================================================================//
 
+template <typename Tp,
+          tim::enable_if_t<std::is_same<Tp, mode::string_key>::value, int> = 0>
+int64_t
+fibonacci(int64_t n, int64_t cutoff)
+{
+    if(n > cutoff)
+    {
+        // the label is hashed every time the bundle is constructed
+        auto_tuple_t _obj{ "fibonacci" };
+        return (n < 2) ? n
+                       : (fibonacci<Tp>(n - 1, cutoff) + fibonacci<Tp>(n - 2, cutoff));
+    }
+    return fibonacci(n);
+}
+
+//======================================================================================//
+
+template <typename Tp,
+          tim::enable_if_t<std::is_same<Tp, mode::static_hash>::value, int> = 0>
+int64_t
+fibonacci(int64_t n, int64_t cutoff)
+{
+    if(n > cutoff)
+    {
+        // the label is hashed at compile-time and registered once per thread
+        auto_tuple_t _obj{ TIMEMORY_STATIC_HASH_ID("fibonacci") };
+        return (n < 2) ? n
+                       : (fibonacci<Tp>(n - 1, cutoff) + fibonacci<Tp>(n - 2, cutoff));
+    }
+    return fibonacci(n);
+}
+
+//======================================================================================//
+
 template <typename Tp>
 result_type
 run(int64_t n, int64_t cutoff, bool store = true)
 {
     // bool is_none  = std::is_same<Tp, mode::none>::value;
     bool is_blank = std::is_same<Tp, mode::blank>::value ||
-                    std::is_same<Tp, mode::blank_pointer>::value;
+                    std::is_same<Tp, mode::blank_pointer>::value ||
+                    std::is_same<Tp, mode::string_key>::value ||
+                    std::is_same<Tp, mode::static_hash>::value;
     bool is_basic = std::is_same<Tp, mode::basic>::value ||
                     std::is_same<Tp, mode::basic_pointer>::value;
 
@@ -343,6 +383,8 @@ main(int argc, char** argv)
     launch<mode::blank_pointer>(nitr, nfib, cutoff, ex_measure, ex_unique, timer_list);
     launch<mode::basic>(nitr, nfib, cutoff, ex_measure, ex_unique, timer_list);
     launch<mode::basic_pointer>(nitr, nfib, cutoff, ex_measure, ex_unique, timer_list);
+    launch<mode::string_key>(nitr, nfib, cutoff, ex_measure, ex_unique, timer_list);
+    launch<mode::static_hash>(nitr, nfib, cutoff, ex_measure, ex_unique, timer_list);
 
     TIMEMORY_CALIPER_APPLY(global, stop);
 
@@ -381,7 +423,7 @@ main(int argc, char** argv)
     {
         ex_unique = ((nfib - cutoff) + 1) * toolkit_size;
         int64_t rc_unique =
-            (tim::storage<wall_clock>::instance()->size() - 6) * toolkit_size;
+            (tim::storage<wall_clock>::instance()->size() - 8) * toolkit_size;
         printf("Expected size: %li, actual size: %li\n", (long) ex_unique,
                (long) rc_unique);
         // ret = (rc_unique == ex_unique) ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -389,7 +431,7 @@ main(int argc, char** argv)
     else
     {
         int64_t rc_unique =
-            (tim::storage<wall_clock>::instance()->size() - 5) * toolkit_size - 4;
+            (tim::storage<wall_clock>::instance()->size() - 7) * toolkit_size - 4;
         printf("Expected size: %li, actual size: %li\n", (long) ex_unique,
                (long) rc_unique);
         // ret = (rc_unique == ex_unique) ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -458,6 +458,7 @@ with warnings.catch_warnings():
                 "timemory-python-line-profiler=timemory.line_profiler.__main__:main",
                 "timemory-python-profiler=timemory.profiler.__main__:main",
                 "timemory-python-trace=timemory.trace.__main__:main",
+                "timemory-binary-to-json=timemory.binary.__main__:main",
             ],
         },
     )
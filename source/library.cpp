@@ -24,14 +24,18 @@
 
 #include "timemory/compat/library.h"
 #include "timemory/config.hpp"
+#include "timemory/hash/concurrent_map.hpp"
 #include "timemory/library.h"
 #include "timemory/runtime/configure.hpp"
 #include "timemory/timemory.hpp"
 #include "timemory/trace.hpp"
 
+#include <algorithm>
 #include <cstdarg>
 #include <deque>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stack>
 #include <unordered_map>
 #include <unordered_set>
@@ -53,10 +57,60 @@ using string_t           = std::string;
 using library_toolset_t  = TIMEMORY_LIBRARY_TYPE;
 using toolset_t          = typename library_toolset_t::component_type;
 using region_map_t       = std::unordered_map<std::string, std::stack<uint64_t>>;
-using record_map_t       = std::unordered_map<uint64_t, toolset_t>;
 using component_enum_t   = std::vector<TIMEMORY_COMPONENT>;
 using components_stack_t = std::deque<component_enum_t>;
 
+// a label and a set of components registered once for timemory_push_region_handle
+struct region_info
+{
+    std::string      name       = {};
+    uint64_t         hash       = 0;
+    component_enum_t components = {};
+};
+
+// the handles are the index of the registration so the per-thread data is a flat array
+struct region_registry
+{
+    std::mutex                                      mutex = {};
+    std::unordered_map<std::string, uint64_t>       keys  = {};
+    tim::concurrent_hash_map<uint64_t, region_info> info  = {};
+};
+
+// the toolsets of one handle on one thread. The toolsets are retained after they are
+// stopped and restarted by the next push at the same recursion depth. The registration
+// is looked up by the first push on the thread and the entries of the registry are
+// never moved so the later pushes and pops do not look it up
+struct region_handle_data
+{
+    const region_info*                      info     = nullptr;
+    size_t                                  depth    = 0;
+    std::vector<std::unique_ptr<toolset_t>> toolsets = {};
+};
+
+using region_handle_array_t = std::vector<region_handle_data>;
+
+// the toolsets of one set of components which are not in use on the thread.
+// timemory_delete_record returns the toolset here and the next timemory_create_record
+// with the same components restarts it so the components are not reallocated
+struct toolset_pool
+{
+    component_enum_t                        components = {};
+    std::vector<std::unique_ptr<toolset_t>> available  = {};
+};
+
+// a toolset started by timemory_create_record and the index of its pool
+struct record_entry
+{
+    uint64_t                   id      = 0;
+    size_t                     pool    = 0;
+    std::unique_ptr<toolset_t> toolset = {};
+};
+
+// the records are usually ended in the reverse order of creation so a vector
+// searched from the back is faster than a map and does not allocate per record
+using record_map_t   = std::vector<record_entry>;
+using toolset_pool_t = std::vector<toolset_pool>;
+
 static std::string spacer =
     "#-------------------------------------------------------------------------#";
 
@@ -71,6 +125,93 @@ get_record_map()
 
 //--------------------------------------------------------------------------------------//
 
+static toolset_pool_t&
+get_toolset_pools()
+{
+    static thread_local toolset_pool_t _instance;
+    return _instance;
+}
+
+//--------------------------------------------------------------------------------------//
+
+static size_t
+get_toolset_pool(int n, const int* ctypes)
+{
+    auto& _pools = get_toolset_pools();
+    for(size_t i = 0; i < _pools.size(); ++i)
+    {
+        const auto& _comp = _pools[i].components;
+        if(_comp.size() == static_cast<size_t>(n) &&
+           std::equal(_comp.begin(), _comp.end(), ctypes))
+            return i;
+    }
+    _pools.emplace_back();
+    _pools.back().components.assign(ctypes, ctypes + n);
+    return _pools.size() - 1;
+}
+
+//--------------------------------------------------------------------------------------//
+// hash of the label without constructing a string when the label is registered
+//
+static uint64_t
+get_record_hash(const char* name)
+{
+    auto _hash = tim::hash_type{}(name);
+    if(tim::get_hash_ids()->find(_hash) == tim::get_hash_ids()->end())
+        tim::add_hash_id(name);
+    return _hash;
+}
+
+//--------------------------------------------------------------------------------------//
+// starts a toolset from the pool, or a new toolset if the pool is empty, and appends
+// it to the records of the thread
+//
+static void
+start_record(uint64_t _id, uint64_t _hash, size_t _pool)
+{
+    static thread_local auto& _record_map = get_record_map();
+    static thread_local auto& _pools      = get_toolset_pools();
+
+    auto  _obj       = std::unique_ptr<toolset_t>{};
+    auto& _available = _pools.at(_pool).available;
+    if(_available.empty())
+    {
+        const auto& _comp = _pools.at(_pool).components;
+        _obj.reset(new toolset_t(_hash, true));
+        tim::initialize(*_obj, _comp.size(), (int*) (_comp.data()));
+    }
+    else
+    {
+        _obj = std::move(_available.back());
+        _available.pop_back();
+        _obj->rekey(_hash);
+        _obj->get_scope() = tim::scope::get_default();
+    }
+    _obj->start();
+    _record_map.emplace_back(record_entry{ _id, _pool, std::move(_obj) });
+}
+
+//--------------------------------------------------------------------------------------//
+// stops the toolset of the record and returns it to its pool
+//
+static void
+stop_record(uint64_t _id)
+{
+    static thread_local auto& _record_map = get_record_map();
+    for(auto itr = _record_map.rbegin(); itr != _record_map.rend(); ++itr)
+    {
+        if(itr->id != _id)
+            continue;
+        itr->toolset->stop();
+        get_toolset_pools().at(itr->pool).available.emplace_back(
+            std::move(itr->toolset));
+        _record_map.erase(std::next(itr).base());
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
 static region_map_t&
 get_region_map()
 {
@@ -80,6 +221,46 @@ get_region_map()
 
 //--------------------------------------------------------------------------------------//
 
+static region_registry&
+get_region_registry()
+{
+    static region_registry _instance{};
+    return _instance;
+}
+
+//--------------------------------------------------------------------------------------//
+
+static region_handle_array_t&
+get_region_handles()
+{
+    static thread_local region_handle_array_t _instance{};
+    return _instance;
+}
+
+//--------------------------------------------------------------------------------------//
+
+static uint64_t
+register_region(const char* name, const component_enum_t& comp)
+{
+    auto _key = std::string{ name };
+    for(auto itr : comp)
+        _key += '\0' + std::to_string(itr);
+
+    auto&                       _registry = get_region_registry();
+    std::lock_guard<std::mutex> _lk{ _registry.mutex };
+    auto                        itr = _registry.keys.find(_key);
+    if(itr != _registry.keys.end())
+        return itr->second;
+
+    uint64_t _handle = _registry.keys.size();
+    _registry.info.emplace(_handle,
+                           region_info{ name, tim::add_hash_id(name), comp });
+    _registry.keys.emplace(std::move(_key), _handle);
+    return _handle;
+}
+
+//--------------------------------------------------------------------------------------//
+
 static components_stack_t&
 get_components_stack()
 {
@@ -157,13 +338,8 @@ extern "C"
         }
         // else: provide default behavior
 
-        static thread_local auto& _record_map = get_record_map();
-        *id                                   = timemory_get_unique_id();
-        _record_map.insert({ *id, toolset_t(name, true) });
-        tim::initialize(_record_map[*id], n, ctypes);
-        _record_map[*id].start();
-        if(_record_map.bucket_count() > _record_map.size())
-            _record_map.rehash(_record_map.size() + 10);
+        *id = timemory_get_unique_id();
+        start_record(*id, get_record_hash(name), get_toolset_pool(n, ctypes));
     }
 
     //----------------------------------------------------------------------------------//
@@ -175,12 +351,10 @@ extern "C"
         {
             (*timemory_delete_function)(id);
         }
-        else if(get_record_map().find(id) != get_record_map().end())
+        else
         {
-            static thread_local auto& _record_map = get_record_map();
-            // stop recording, destroy objects, and erase key from map
-            _record_map[id].stop();
-            _record_map.erase(id);
+            // stop recording, return the toolset to the pool and erase the entry
+            stop_record(id);
         }
     }
 
@@ -234,14 +408,23 @@ extern "C"
         // is called and there is not a concern for the map iterator
         std::unordered_set<uint64_t> keys;
         for(auto& itr : _record_map)
-            keys.insert(itr.first);
+            keys.insert(itr.id);
 
         // delete all the records
         for(auto& itr : keys)
             timemory_delete_record(itr);
 
-        // clear the map
+        // clear the map and destroy the pooled toolsets
         _record_map.clear();
+        get_toolset_pools().clear();
+
+        // stop and destroy the toolsets of the region handles
+        for(auto& itr : get_region_handles())
+        {
+            for(; itr.depth > 0; --itr.depth)
+                itr.toolsets.at(itr.depth - 1)->stop();
+        }
+        get_region_handles().clear();
 
         // have the manager finalize
         tim::manager::instance()->finalize();
@@ -274,6 +457,28 @@ extern "C"
     //
     void timemory_resume(void) { tim::settings::enabled() = true; }
 
+    //----------------------------------------------------------------------------------//
+    //  heap bytes held by the storage
+    //
+    uint64_t timemory_get_memory_usage(void)
+    {
+        using tuple_type = tim::convert_t<tim::available_types_t, tim::type_list<>>;
+        return tim::manager::get_storage<tuple_type>::usage().total();
+    }
+
+    uint64_t timemory_get_component_memory_usage(int _component)
+    {
+        using tuple_type = tim::convert_t<tim::available_types_t, tim::type_list<>>;
+        uint64_t _sum    = 0;
+        for(const auto& citr : tim::manager::get_storage<tuple_type>::usage(
+                {}, { static_cast<TIMEMORY_COMPONENT>(_component) }))
+        {
+            for(const auto& itr : citr.second)
+                _sum += itr.total();
+        }
+        return _sum;
+    }
+
     //----------------------------------------------------------------------------------//
 
     void timemory_set_default(const char* _component_string)
@@ -513,6 +718,67 @@ extern "C"
 
     //----------------------------------------------------------------------------------//
 
+    void timemory_begin_records(int n, const char** names, uint64_t* ids)
+    {
+        tim::trace::lock<tim::trace::library> lk{};
+        if(!lk || tim::settings::enabled() == false)
+        {
+            std::fill(ids, ids + n, std::numeric_limits<uint64_t>::max());
+            return;
+        }
+
+        auto& comp = get_current_components();
+        if(timemory_create_function)
+        {
+            for(int i = 0; i < n; ++i)
+                timemory_create_record(names[i], &ids[i], comp.size(),
+                                       (int*) (comp.data()));
+            return;
+        }
+
+        // the records share the components so the pool is looked up once
+        auto _pool = get_toolset_pool(comp.size(), (int*) (comp.data()));
+        get_record_map().reserve(get_record_map().size() + n);
+        for(int i = 0; i < n; ++i)
+        {
+            ids[i] = timemory_get_unique_id();
+            start_record(ids[i], get_record_hash(names[i]), _pool);
+        }
+
+#if defined(DEBUG)
+        if(tim::settings::verbose() > 2)
+            printf("beginning %i records (first id = %lli)...\n", n,
+                   (long long int) ids[0]);
+#endif
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    void timemory_end_records(int n, const uint64_t* ids)
+    {
+        tim::trace::lock<tim::trace::library> lk{};
+        if(!lk)
+            return;
+
+        // the records are ended in the reverse order of the array
+        for(int i = n - 1; i >= 0; --i)
+        {
+            if(ids[i] == std::numeric_limits<uint64_t>::max())
+                continue;
+            if(timemory_delete_function)
+                (*timemory_delete_function)(ids[i]);
+            else
+                stop_record(ids[i]);
+        }
+
+#if defined(DEBUG)
+        if(tim::settings::verbose() > 2)
+            printf("ending %i records...\n", n);
+#endif
+    }
+
+    //----------------------------------------------------------------------------------//
+
     void timemory_push_region(const char* name)
     {
         tim::trace::lock<tim::trace::library> lk{};
@@ -546,6 +812,95 @@ extern "C"
         }
     }
 
+    //----------------------------------------------------------------------------------//
+
+    uint64_t timemory_register_region(const char* name)
+    {
+        tim::trace::lock<tim::trace::library> lk{};
+        return register_region(name, get_current_components());
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    uint64_t timemory_register_region_types(const char* name, const char* ctypes)
+    {
+        tim::trace::lock<tim::trace::library> lk{};
+        return register_region(name, tim::enumerate_components(std::string(ctypes)));
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    void timemory_push_region_handle(uint64_t handle)
+    {
+        tim::trace::lock<tim::trace::library> lk{};
+        if(!lk || tim::settings::enabled() == false)
+            return;
+
+        static thread_local auto& _handles = get_region_handles();
+        if(handle >= _handles.size() || !_handles[handle].info)
+        {
+            auto itr = get_region_registry().info.find(handle);
+            if(itr == get_region_registry().info.end())
+            {
+                fprintf(stderr, "Warning! region handle %llu does not exist!\n",
+                        (unsigned long long) handle);
+                return;
+            }
+            if(handle >= _handles.size())
+                _handles.resize(handle + 1);
+            _handles[handle].info = &itr->second;
+        }
+
+        auto& _data = _handles[handle];
+
+        // a custom create function receives the label
+        if(timemory_create_function)
+        {
+            lk.release();
+            timemory_push_region(_data.info->name.c_str());
+            return;
+        }
+
+        if(_data.depth == _data.toolsets.size())
+        {
+            _data.toolsets.emplace_back(new toolset_t(_data.info->hash, true));
+            auto& _comp = _data.info->components;
+            tim::initialize(*_data.toolsets.back(), _comp.size(), (int*) (_comp.data()));
+        }
+        _data.toolsets[_data.depth++]->start();
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    void timemory_pop_region_handle(uint64_t handle)
+    {
+        tim::trace::lock<tim::trace::library> lk{};
+        if(!lk)
+            return;
+
+        static thread_local auto& _handles = get_region_handles();
+        if(timemory_create_function)
+        {
+            // the push of the handle cached the registration on this thread
+            if(handle < _handles.size() && _handles[handle].info)
+            {
+                lk.release();
+                timemory_pop_region(_handles[handle].info->name.c_str());
+            }
+            return;
+        }
+
+        if(handle >= _handles.size() || _handles[handle].depth == 0)
+        {
+            fprintf(stderr, "Warning! region handle %llu was not pushed!\n",
+                    (unsigned long long) handle);
+            return;
+        }
+
+        auto& _data = _handles[handle];
+        _data.toolsets[--_data.depth]->stop();
+    }
+
     //==================================================================================//
     //
     //      Symbols for Fortran
@@ -600,10 +955,40 @@ extern "C"
 
     void timemory_end_record_(uint64_t id) { return timemory_end_record(id); }
 
+    void timemory_begin_records_(int n, const char** names, uint64_t* ids)
+    {
+        timemory_begin_records(n, names, ids);
+    }
+
+    void timemory_end_records_(int n, const uint64_t* ids)
+    {
+        timemory_end_records(n, ids);
+    }
+
     void timemory_push_region_(const char* name) { return timemory_push_region(name); }
 
     void timemory_pop_region_(const char* name) { return timemory_pop_region(name); }
 
+    uint64_t timemory_register_region_(const char* name)
+    {
+        return timemory_register_region(name);
+    }
+
+    uint64_t timemory_register_region_types_(const char* name, const char* ctypes)
+    {
+        return timemory_register_region_types(name, ctypes);
+    }
+
+    void timemory_push_region_handle_(uint64_t handle)
+    {
+        return timemory_push_region_handle(handle);
+    }
+
+    void timemory_pop_region_handle_(uint64_t handle)
+    {
+        return timemory_pop_region_handle(handle);
+    }
+
     //======================================================================================//
 
 }  // extern "C"
@@ -456,6 +456,27 @@ PYBIND11_MODULE(libpytimemory, tim)
         return manager_t::get_storage<tuple_type>::size(_types);
     };
     //----------------------------------------------------------------------------------//
+    auto _get_memory_usage = [](py::list _list) {
+        auto _types = pytim::get_enum_set(_list);
+        if(_types.empty())
+            _types = pytim::get_type_enums<tim::available_types_t>();
+        using tuple_type = tim::convert_t<tim::available_types_t, tim::type_list<>>;
+        using entry_type = std::map<std::string, int64_t>;
+        manager_t::enum_map_t<std::vector<entry_type>> _ret{};
+        for(const auto& citr : manager_t::get_storage<tuple_type>::usage({}, _types))
+        {
+            auto& _entries = _ret[citr.first];
+            for(const auto& itr : citr.second)
+            {
+                entry_type _entry{ { "tid", itr.tid } };
+                for(const auto& eitr : itr.entries())
+                    _entry[eitr.first] = static_cast<int64_t>(eitr.second);
+                _entries.emplace_back(_entry);
+            }
+        }
+        return _ret;
+    };
+    //----------------------------------------------------------------------------------//
     auto _as_json_classic = [](const pytim::pyenum_set_t& _types) -> std::string {
         using tuple_type = tim::convert_t<tim::available_types_t, tim::type_list<>>;
         auto json_str    = manager_t::get_storage<tuple_type>::serialize(_types);
@@ -739,6 +760,12 @@ PYBIND11_MODULE(libpytimemory, tim)
             "argument will return the size for all available types",
             py::arg("components") = py::list{});
     //----------------------------------------------------------------------------------//
+    tim.def("memory_usage", _get_memory_usage,
+            "Get the bytes held by the storage of component types for each thread, "
+            "broken down by data structure. An empty list as the first argument will "
+            "return the usage for all available types",
+            py::arg("components") = py::list{});
+    //----------------------------------------------------------------------------------//
     tim.def("mpi_init", _init_mpi, "Initialize MPI");
     //----------------------------------------------------------------------------------//
     tim.def("mpi_finalize", _finalize_mpi, "Finalize MPI");
@@ -30,9 +30,11 @@ TIMEMORY_TEST_DEFAULT_MAIN
 
 #include <chrono>
 #include <condition_variable>
+#include <fstream>
 #include <iostream>
 #include <mutex>
 #include <random>
+#include <sstream>
 #include <thread>
 #include <vector>
 
@@ -371,5 +373,92 @@ TEST_F(archive_storage_tests, check_archive)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(archive_storage_tests, binary_output)
+{
+    if(tim::dmp::rank() > 0)
+        return;
+
+    using print_t = tim::operation::finalize::print<wall_clock, true>;
+
+    print_t _print{ tim::storage<wall_clock>::instance() };
+    auto    _fname =
+        tim::settings::compose_output_filename(details::get_test_name(), "bin");
+    _print.print_binary(_fname, _print.get_node_results(), 2);
+
+    tim::binary_output::reader _reader{ _fname };
+    ASSERT_TRUE(_reader.is_valid()) << _reader.get_error();
+    EXPECT_EQ(_reader.get_header().nvalues, 1);
+    EXPECT_EQ(_reader.get_metadata().label, _print.get_label());
+    EXPECT_EQ(_reader.get_metadata().unit, wall_clock::get_display_unit());
+    EXPECT_EQ(_reader.get_metadata().concurrency, 2);
+
+    // the nodes are read back in the same order with the same values
+    std::vector<const print_t::result_node*> _nodes{};
+    for(const auto& ritr : _print.get_node_results())
+        for(const auto& itr : ritr)
+            _nodes.emplace_back(&itr);
+
+    size_t _idx = 0;
+    auto   _n   = _reader.read([&](const tim::binary_output::node& _node) {
+        ASSERT_LT(_idx, _nodes.size());
+        const auto& _ref = *_nodes.at(_idx++);
+        EXPECT_EQ(_node.hash, _ref.hash());
+        EXPECT_EQ(_node.depth, _ref.depth());
+        EXPECT_EQ(_node.tid, _ref.tid());
+        EXPECT_EQ(_node.prefix, _ref.prefix());
+        EXPECT_EQ(_node.laps, _ref.data().get_laps());
+        EXPECT_DOUBLE_EQ(_node.values.at(0), _ref.data().get());
+    });
+    EXPECT_EQ(_n, _nodes.size());
+    EXPECT_GT(_n, 0);
+    EXPECT_TRUE(_reader.is_valid()) << _reader.get_error();
+
+    // the conversion to json can be read by the json archive
+    auto _json = tim::binary_output::write_json(_fname);
+    ASSERT_FALSE(_json.empty());
+    std::ifstream ifs{ _json };
+    ASSERT_TRUE(ifs);
+    tim::cereal::JSONInputArchive ar{ ifs };
+    ar.setNextName("timemory");
+    ar.startNode();
+    ar.setNextName(_print.get_label().c_str());
+    ar.startNode();
+    int64_t _num_ranks = 0;
+    ar(tim::cereal::make_nvp("num_ranks", _num_ranks));
+    EXPECT_EQ(_num_ranks, 1);
+    ar.finishNode();
+    ar.finishNode();
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(archive_storage_tests, streaming_json)
+{
+    if(tim::dmp::size() > 1)
+        return;
+
+    using print_t = tim::operation::finalize::print<wall_clock, true>;
+
+    print_t _print{ tim::storage<wall_clock>::instance() };
+    auto    _results = _print.get_node_results();
+    auto    _name    = details::get_test_name();
+    auto    _copied  = tim::settings::compose_output_filename(_name + "_copied", "json");
+    auto    _stream  = tim::settings::compose_output_filename(_name + "_stream", "json");
+    _print.print_json(_copied, _results, 2);
+    _print.print_json(_stream, 2);
+
+    auto _read = [](const std::string& _fname) {
+        std::ifstream     ifs{ _fname };
+        std::stringstream ss{};
+        ss << ifs.rdbuf();
+        return ss.str();
+    };
+
+    // the JSON written from the graph is identical to the JSON of the results
+    auto _expected = _read(_copied);
+    EXPECT_FALSE(_expected.empty());
+    EXPECT_EQ(_expected, _read(_stream));
+}
+
 // ensure the storage is initialized on the master thread
 TIMEMORY_INITIALIZE_STORAGE(wall_clock, cpu_clock, current_peak_rss)
@@ -0,0 +1,278 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_macros.hpp"
+
+TIMEMORY_TEST_DEFAULT_MAIN
+
+#include "timemory/timemory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace tim::component;
+
+using node_type       = tim::node::graph<wall_clock>;
+using tgraph_node_t   = tim::tgraph_node<node_type>;
+using slab_graph_t    = tim::graph<node_type, tim::graph_allocator<tgraph_node_t>>;
+using default_graph_t = tim::graph<node_type, std::allocator<tgraph_node_t>>;
+
+static const int64_t nwidth = 64;
+static const int64_t ndepth = 8;
+static const int64_t nreps  = 8;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return std::string(::testing::UnitTest::GetInstance()->current_test_suite()->name()) +
+           "." + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// build a tree with nwidth children per node at each depth (only the last child of
+// each level is expanded) and return the number of nodes inserted
+template <typename GraphT>
+int64_t
+populate(GraphT& _graph, int64_t _width = nwidth, int64_t _depth = ndepth)
+{
+    int64_t _n    = 0;
+    auto    _itr  = _graph.set_head(node_type(0, wall_clock{}, 0, 0));
+    auto    _next = _itr;
+    for(int64_t d = 1; d <= _depth; ++d)
+    {
+        for(int64_t w = 0; w < _width; ++w)
+        {
+            auto _hash = static_cast<uint64_t>(d * _width + w + 1);
+            _next      = _graph.append_child(_itr, node_type(_hash, wall_clock{}, d, 0));
+            ++_n;
+        }
+        _itr = _next;
+    }
+    return _n;
+}
+
+// measure the insertion rate (inserts/sec) and the change in RSS (bytes)
+template <typename GraphT>
+std::pair<double, int64_t>
+benchmark(const std::string& _label)
+{
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double>;
+
+    int64_t    _ninsert = 0;
+    auto       _rss_beg = tim::get_page_rss();
+    auto       _graphs  = std::vector<std::unique_ptr<GraphT>>{};
+    duration_t _elapsed{ 0.0 };
+    for(int64_t i = 0; i < nreps; ++i)
+    {
+        _graphs.emplace_back(std::make_unique<GraphT>());
+        auto _beg = clock_type::now();
+        _ninsert += populate(*_graphs.back(), 4 * nwidth, 4 * ndepth);
+        _elapsed += clock_type::now() - _beg;
+    }
+    auto _rss_end = tim::get_page_rss();
+    _graphs.clear();
+
+    auto _rate = _ninsert / _elapsed.count();
+    std::cout << std::setw(16) << _label << " : " << std::setw(12) << std::setprecision(6)
+              << std::fixed << _rate << " inserts/sec, " << std::setw(10)
+              << (_rss_end - _rss_beg) / tim::units::KiB << " KiB RSS for " << _ninsert
+              << " nodes" << std::endl;
+    return { _rate, _rss_end - _rss_beg };
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class graph_allocator_tests : public ::testing::Test
+{
+protected:
+    TIMEMORY_TEST_DEFAULT_SUITE_BODY
+};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(graph_allocator_tests, recycle)
+{
+    slab_graph_t _graph{};
+    auto         _n = details::populate(_graph);
+
+    EXPECT_EQ(_graph.size(), static_cast<size_t>(_n + 1));
+    auto _nbytes = _graph.get_allocator().alloc_bytes();
+    EXPECT_GE(_nbytes, static_cast<size_t>(_n) * sizeof(tgraph_node_t));
+
+    // erasing the children returns the nodes to the free-list and re-populating
+    // the graph should not reserve any new memory
+    _graph.erase_children(_graph.begin());
+    EXPECT_EQ(_graph.size(), static_cast<size_t>(1));
+    EXPECT_EQ(_graph.get_allocator().alloc_bytes(), _nbytes);
+
+    for(int64_t i = 0; i < _n; ++i)
+        _graph.append_child(_graph.begin(), node_type(1000 + i, wall_clock{}, 1, 0));
+    EXPECT_EQ(_graph.size(), static_cast<size_t>(_n + 1));
+    EXPECT_EQ(_graph.get_allocator().alloc_bytes(), _nbytes);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(graph_allocator_tests, bulk_release)
+{
+    slab_graph_t _graph{};
+    details::populate(_graph);
+
+    EXPECT_GT(_graph.get_allocator().alloc_bytes(), static_cast<size_t>(0));
+    _graph.clear();
+    EXPECT_TRUE(_graph.empty());
+    EXPECT_EQ(_graph.get_allocator().alloc_bytes(), static_cast<size_t>(0));
+
+    // graph is still usable after the memory is released
+    auto _n = details::populate(_graph);
+    EXPECT_EQ(_graph.size(), static_cast<size_t>(_n + 1));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(graph_allocator_tests, copy_and_move)
+{
+    slab_graph_t _graph{};
+    auto         _n = details::populate(_graph);
+
+    // copies have independent memory
+    slab_graph_t _copy{ _graph };
+    EXPECT_EQ(_copy.size(), static_cast<size_t>(_n + 1));
+    EXPECT_NE(_copy.get_allocator(), _graph.get_allocator());
+
+    // moves share the memory of the nodes that were moved
+    slab_graph_t _move{ std::move(_copy) };
+    EXPECT_EQ(_move.size(), static_cast<size_t>(_n + 1));
+    EXPECT_EQ(_move.get_allocator(), _copy.get_allocator());
+    EXPECT_EQ(_move.get_allocator().use_count(), 2);
+
+    // when the memory is shared, clearing one graph cannot release it
+    _copy.clear();
+    EXPECT_EQ(_move.size(), static_cast<size_t>(_n + 1));
+    EXPECT_GT(_move.get_allocator().alloc_bytes(), static_cast<size_t>(0));
+
+    auto _bitr = _graph.begin();
+    for(auto itr = _move.begin(); itr != _move.end(); ++itr, ++_bitr)
+        EXPECT_EQ(itr->id(), _bitr->id()) << details::get_test_name();
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(graph_allocator_tests, move_assign)
+{
+    slab_graph_t _graph{};
+    auto         _n = details::populate(_graph);
+
+    // the target holds the only reference to its memory so the existing nodes must be
+    // destroyed before the memory of the source is adopted
+    slab_graph_t _target{};
+    details::populate(_target, nwidth / 2, ndepth / 2);
+    _target = std::move(_graph);
+
+    EXPECT_EQ(_target.size(), static_cast<size_t>(_n + 1));
+    EXPECT_EQ(_target.get_allocator().use_count(), 2);
+
+    // the last top-level node is reachable from the end
+    auto _last = _target.end();
+    --_last;
+    EXPECT_EQ(_last->id(), static_cast<uint64_t>(ndepth * nwidth + nwidth));
+
+    // moving an empty graph leaves an empty graph
+    slab_graph_t _empty{};
+    _target = std::move(_empty);
+    EXPECT_TRUE(_target.empty());
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(graph_allocator_tests, splice)
+{
+    slab_graph_t _target{};
+    details::populate(_target, nwidth / 2, ndepth / 2);
+    auto _ntarget = _target.size();
+
+    auto _source = std::make_unique<slab_graph_t>();
+    auto _n      = details::populate(*_source);
+    auto _ids    = std::vector<uint64_t>{};
+    for(auto itr = _source->begin(); itr != _source->end(); ++itr)
+        _ids.emplace_back(itr->id());
+
+    // the nodes of the source must remain valid after the source releases its memory
+    auto _top = _target.move_in_below(_target.begin(), *_source);
+    EXPECT_TRUE(_source->empty());
+    _source.reset();
+
+    EXPECT_EQ(_target.size(), _ntarget + _n + 1);
+    EXPECT_EQ(slab_graph_t::depth(_top), 1);
+    size_t _idx = 0;
+    for(auto itr = slab_graph_t::iterator{ _top }; _idx < _ids.size(); ++itr, ++_idx)
+        EXPECT_EQ(itr->id(), _ids.at(_idx)) << details::get_test_name();
+
+    // the graph which is moved out shares the memory of the nodes
+    auto _moved = _target.move_out(_top);
+    EXPECT_EQ(_moved.get_allocator(), _target.get_allocator());
+    EXPECT_EQ(_moved.size(), static_cast<size_t>(_n + 1));
+    EXPECT_EQ(_target.size(), _ntarget);
+
+    _target.clear();
+    _idx = 0;
+    for(auto itr = _moved.begin(); itr != _moved.end(); ++itr, ++_idx)
+        EXPECT_EQ(itr->id(), _ids.at(_idx)) << details::get_test_name();
+    EXPECT_EQ(_idx, _ids.size());
+
+    // moving into a graph with other memory copies the nodes
+    slab_graph_t _other{};
+    _other.set_head(node_type(0, wall_clock{}, 0, 0));
+    auto _nbytes = _other.get_allocator().alloc_bytes();
+    _other.move_in_below(_other.begin(), _moved);
+    EXPECT_EQ(_other.size(), static_cast<size_t>(_n + 2));
+    EXPECT_GT(_other.get_allocator().alloc_bytes(), _nbytes);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(graph_allocator_tests, benchmark)
+{
+    auto _std  = details::benchmark<default_graph_t>("std::allocator");
+    auto _slab = details::benchmark<slab_graph_t>("graph_allocator");
+
+    std::cout << "\ngraph_allocator speed-up: " << std::setprecision(3)
+              << (_slab.first / _std.first) << "x\n"
+              << std::endl;
+
+    EXPECT_GT(_slab.first, 0.0);
+    EXPECT_GT(_std.first, 0.0);
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,246 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_macros.hpp"
+
+TIMEMORY_TEST_DEFAULT_MAIN
+
+#include "timemory/timemory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace hash = tim::hash;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return std::string(::testing::UnitTest::GetInstance()->current_test_suite()->name()) +
+           "." + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// labels in the style generated by the marker macros and the instrumentation tools:
+// function, file, line and arguments
+std::vector<std::string>
+get_labels(size_t _n)
+{
+    static const char* _funcs[] = { "compute", "MPI_Allreduce", "std::vector<double>::at",
+                                    "solver::iterate", "main" };
+    static const char* _files[] = { "ex_cxx_overhead.cpp", "source/timemory/library.cpp",
+                                    "src/physics/hydro/riemann_solver.cpp" };
+    std::vector<std::string> _labels{};
+    _labels.reserve(_n);
+    for(size_t i = 0; i < _n; ++i)
+    {
+        _labels.emplace_back(TIMEMORY_JOIN("", _funcs[i % 5], "@", _files[i % 3], ":",
+                                           (i % 4096), "/iteration-", i));
+    }
+    return _labels;
+}
+
+// measure the hash rate (bytes/sec) of the function over the labels
+template <typename FuncT>
+double
+benchmark(const std::string& _label, const std::vector<std::string>& _labels,
+          FuncT&& _func)
+{
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double>;
+
+    size_t   _nbytes = 0;
+    uint64_t _sum    = 0;
+    auto     _beg    = clock_type::now();
+    for(int i = 0; i < 10; ++i)
+    {
+        for(const auto& itr : _labels)
+        {
+            _sum += _func(itr);
+            _nbytes += itr.length();
+        }
+    }
+    duration_t _elapsed = clock_type::now() - _beg;
+
+    auto _rate = _nbytes / _elapsed.count() / tim::units::MB;
+    std::cout << std::setw(16) << _label << " : " << std::setw(12) << std::setprecision(3)
+              << std::fixed << _rate << " MB/sec (" << (_sum % 10) << ")" << std::endl;
+    return _rate;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class hash_tests : public ::testing::Test
+{
+protected:
+    TIMEMORY_TEST_DEFAULT_SUITE_BODY
+};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(hash_tests, reference)
+{
+    // the test vectors of the reference implementations (wyhash uses the index as seed)
+    static_assert(hash::fnv1a::compute("", 0) == 0xcbf29ce484222325ULL, "fnv1a");
+    static_assert(hash::fnv1a::compute("a", 1) == 0xaf63dc4c8601ec8cULL, "fnv1a");
+    static_assert(hash::fnv1a::compute("foobar", 6) == 0x85944171f73967e8ULL, "fnv1a");
+    static_assert(hash::wyhash::compute("", 0, 0) == 0x93228a4de0eec5a2ULL, "wyhash");
+
+    std::vector<std::pair<std::string, uint64_t>> _vectors = {
+        { "", 0x93228a4de0eec5a2ULL },
+        { "a", 0xc5bac3db178713c4ULL },
+        { "abc", 0xa97f2f7b1d9b3314ULL },
+        { "message digest", 0x786d1f1df3801df4ULL },
+        { "abcdefghijklmnopqrstuvwxyz", 0xdca5a8138ad37c87ULL },
+        { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+          0xb9e734f117cfaf70ULL },
+        { "123456789012345678901234567890123456789012345678901234567890123456789012345"
+          "67890",
+          0x6cc5eab49a92d617ULL }
+    };
+
+    for(size_t i = 0; i < _vectors.size(); ++i)
+    {
+        const auto& itr = _vectors.at(i);
+        EXPECT_EQ(hash::wyhash::compute(itr.first.c_str(), itr.first.length(), i),
+                  itr.second)
+            << itr.first;
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(hash_tests, compile_time)
+{
+    constexpr auto _hash = tim::hash_type{}("hash_tests/compile_time");
+    static_assert(_hash == tim::hash_type::compute("hash_tests/compile_time", 23),
+                  "length computed at compile-time");
+    EXPECT_EQ(_hash, tim::get_hash_id(std::string{ "hash_tests/compile_time" }));
+
+    // every length class of wyhash: 0, 1-3, 4-16, 17-48 and > 48 bytes
+    std::string _label{};
+    for(size_t i = 0; i < 160; ++i)
+    {
+        auto _cstr = tim::hash_type{}(_label.c_str());
+        auto _str  = tim::hash_type{}(_label);
+        EXPECT_EQ(_cstr, _str) << "length " << i;
+        EXPECT_EQ(_str, tim::get_hash_id(_label)) << "length " << i;
+        _label += static_cast<char>('a' + (i % 26));
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(hash_tests, collision_check)
+{
+    auto _hash_map = std::make_shared<tim::graph_hash_map_t>();
+    auto _hash     = tim::get_hash_id("foo");
+
+    // simulate a collision by registering a different label with the same hash
+    _hash_map->emplace(_hash, std::string{ "bar" });
+
+    auto& _check = tim::get_hash_collision_check();
+    auto  _prev  = _check.load();
+    auto  _init  = tim::get_hash_collisions().load();
+
+    _check.store(false);
+    EXPECT_EQ(tim::add_hash_id(_hash_map, "foo"), _hash);
+    EXPECT_EQ(tim::get_hash_collisions().load(), _init);
+
+    _check.store(true);
+    EXPECT_EQ(tim::add_hash_id(_hash_map, "foo"), _hash);
+    EXPECT_EQ(tim::get_hash_collisions().load(), _init + 1);
+
+    // the same label is not a collision
+    auto _baz = tim::add_hash_id(_hash_map, "baz");
+    EXPECT_EQ(tim::add_hash_id(_hash_map, "baz"), _baz);
+    EXPECT_EQ(tim::get_hash_collisions().load(), _init + 1);
+    EXPECT_EQ(_hash_map->find(_hash)->second, "bar");
+
+    _check.store(_prev);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(hash_tests, distribution)
+{
+    auto _labels = details::get_labels(1 << 18);
+
+    std::unordered_set<uint64_t> _wy{};
+    std::unordered_set<uint64_t> _fnv{};
+    for(const auto& itr : _labels)
+    {
+        _wy.insert(hash::wyhash::compute(itr.data(), itr.length()));
+        _fnv.insert(hash::fnv1a::compute(itr.data(), itr.length()));
+    }
+    EXPECT_EQ(_wy.size(), _labels.size());
+    EXPECT_EQ(_fnv.size(), _labels.size());
+
+    // the buckets of a power-of-two table are selected by the low bits
+    const size_t        _nbins = 256;
+    std::vector<size_t> _bins(_nbins, 0);
+    for(const auto& itr : _wy)
+        ++_bins.at(itr % _nbins);
+    auto _expected = _labels.size() / _nbins;
+    for(const auto& itr : _bins)
+    {
+        EXPECT_GT(itr, _expected / 2);
+        EXPECT_LT(itr, 2 * _expected);
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(hash_tests, benchmark)
+{
+    auto _labels = details::get_labels(1 << 16);
+
+    auto _std = details::benchmark("std::hash", _labels, std::hash<std::string>{});
+    auto _fnv = details::benchmark("fnv1a", _labels, [](const std::string& _v) {
+        return hash::fnv1a::compute(_v.data(), _v.length());
+    });
+    auto _wy  = details::benchmark("wyhash", _labels, [](const std::string& _v) {
+        return hash::wyhash::compute(_v.data(), _v.length());
+    });
+
+    std::cout << "\nwyhash speed-up: " << std::setprecision(3) << (_wy / _fnv)
+              << "x vs. fnv1a, " << (_wy / _std) << "x vs. std::hash\n"
+              << std::endl;
+
+    EXPECT_GT(_std, 0.0);
+    EXPECT_GT(_fnv, 0.0);
+    EXPECT_GT(_wy, 0.0);
+}
+
+//--------------------------------------------------------------------------------------//
@@ -27,12 +27,15 @@
 #include "timemory/compat/timemory_c.h"
 #include "timemory/library.h"
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <limits>
 #include <mutex>
+#include <new>
 #include <random>
 #include <sstream>
 #include <string>
@@ -109,10 +112,49 @@ consume(long n)
         try_lk.try_lock();
 }
 
+// the heap allocations on every thread are counted while enabled
+inline std::atomic<bool>&
+count_allocations()
+{
+    static std::atomic<bool> _instance{ false };
+    return _instance;
+}
+
+inline std::atomic<int64_t>&
+allocations()
+{
+    static std::atomic<int64_t> _instance{ 0 };
+    return _instance;
+}
+
 }  // namespace details
 
 //--------------------------------------------------------------------------------------//
 
+void*
+operator new(size_t _n)
+{
+    if(details::count_allocations().load(std::memory_order_relaxed))
+        ++details::allocations();
+    if(void* _p = std::malloc((_n > 0) ? _n : 1))
+        return _p;
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void* _p) noexcept
+{
+    std::free(_p);
+}
+
+void
+operator delete(void* _p, size_t) noexcept
+{
+    std::free(_p);
+}
+
+//--------------------------------------------------------------------------------------//
+
 class library_tests : public ::testing::Test
 {
 protected:
@@ -421,6 +463,170 @@ TEST_F(library_tests, region)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(library_tests, region_handle)
+{
+    printf("TEST_NAME: %s\n", details::get_test_name().c_str());
+
+    auto idx = timemory_register_region(TEST_NAME);
+    EXPECT_EQ(timemory_register_region(TEST_NAME), idx);
+    EXPECT_NE(timemory_register_region(TIMEMORY_JOIN("/", TEST_NAME, "other").c_str()),
+              idx);
+
+    timemory_push_region_handle(idx);
+    ret += details::fibonacci(35);
+
+    timemory_push_region_handle(idx);
+    ret += details::fibonacci(35);
+
+    timemory_pop_region_handle(idx);
+    timemory_pop_region_handle(idx);
+
+    printf("fibonacci(35) = %li\n\n", ret);
+
+    auto wc_n = wc_size_orig + 2;
+    auto cu_n = cu_size_orig + 2;
+    auto cc_n = cc_size_orig + 2;
+    auto pr_n = pr_size_orig + 2;
+
+    ASSERT_EQ(get_wc_storage_size(), wc_n);
+    ASSERT_EQ(get_cu_storage_size(), cu_n);
+    ASSERT_EQ(get_cc_storage_size(), cc_n);
+    ASSERT_EQ(get_pr_storage_size(), pr_n);
+
+    // the cost of a push/pop pair by label and by handle
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double, std::nano>;
+
+    constexpr int nitr = 10000;
+    auto          _beg = clock_type::now();
+    for(int i = 0; i < nitr; ++i)
+    {
+        timemory_push_region(TEST_NAME);
+        timemory_pop_region(TEST_NAME);
+    }
+    duration_t _label = clock_type::now() - _beg;
+
+    _beg = clock_type::now();
+    for(int i = 0; i < nitr; ++i)
+    {
+        timemory_push_region_handle(idx);
+        timemory_pop_region_handle(idx);
+    }
+    duration_t _handle = clock_type::now() - _beg;
+
+    printf("push/pop region: %.3f nsec (label) vs. %.3f nsec (handle)\n\n",
+           _label.count() / nitr, _handle.count() / nitr);
+
+    // the repeated pushes located the existing entries
+    ASSERT_EQ(get_wc_storage_size(), wc_n);
+    ASSERT_EQ(get_pr_storage_size(), pr_n);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(library_tests, record_pool)
+{
+    printf("TEST_NAME: %s\n", details::get_test_name().c_str());
+
+    std::string _label = TEST_NAME;
+
+    // the first records create the toolsets, the nodes and the per-thread data
+    for(int i = 0; i < 4; ++i)
+    {
+        auto idx = timemory_get_begin_record(_label.c_str());
+        ret += details::fibonacci(10);
+        timemory_end_record(idx);
+    }
+
+    auto wc_n = wc_size_orig + 1;
+    auto pr_n = pr_size_orig + 1;
+
+    // the following records reuse the pooled toolsets
+    constexpr int64_t nitr = 1000;
+    details::allocations().store(0);
+    details::count_allocations().store(true);
+    for(int64_t i = 0; i < nitr; ++i)
+    {
+        auto idx = timemory_get_begin_record(_label.c_str());
+        ret += details::fibonacci(10);
+        timemory_end_record(idx);
+    }
+    details::count_allocations().store(false);
+
+    auto _nalloc = details::allocations().load();
+    printf("heap allocations per begin/end record: %.3f\n\n",
+           static_cast<double>(_nalloc) / nitr);
+
+    // the toolsets are reused so the only allocations are the entries of the set of
+    // running objects in the storage of each of the four default components
+    EXPECT_LE(_nalloc, 4 * nitr);
+    ASSERT_EQ(get_wc_storage_size(), wc_n);
+    ASSERT_EQ(get_pr_storage_size(), pr_n);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(library_tests, batch_record)
+{
+    printf("TEST_NAME: %s\n", details::get_test_name().c_str());
+
+    std::vector<std::string> _labels{};
+    for(int i = 0; i < 3; ++i)
+        _labels.emplace_back(TIMEMORY_JOIN("/", TEST_NAME, i));
+    std::vector<const char*> _names{};
+    for(auto& itr : _labels)
+        _names.emplace_back(itr.c_str());
+
+    std::vector<uint64_t> _ids(_names.size(), 0);
+    timemory_begin_records(_names.size(), _names.data(), _ids.data());
+    ret += details::fibonacci(35);
+    timemory_end_records(_ids.size(), _ids.data());
+
+    printf("fibonacci(35) = %li\n\n", ret);
+
+    // the records are nested so each label is a new node
+    auto wc_n = wc_size_orig + 3;
+    auto cu_n = cu_size_orig + 3;
+    auto cc_n = cc_size_orig + 3;
+    auto pr_n = pr_size_orig + 3;
+
+    ASSERT_EQ(get_wc_storage_size(), wc_n);
+    ASSERT_EQ(get_cu_storage_size(), cu_n);
+    ASSERT_EQ(get_cc_storage_size(), cc_n);
+    ASSERT_EQ(get_pr_storage_size(), pr_n);
+
+    // the cost of beginning and ending the records one at a time and in one call
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double, std::nano>;
+
+    constexpr int nitr = 10000;
+    auto          _beg = clock_type::now();
+    for(int i = 0; i < nitr; ++i)
+    {
+        for(size_t j = 0; j < _names.size(); ++j)
+            timemory_begin_record(_names[j], &_ids[j]);
+        for(size_t j = _ids.size(); j > 0; --j)
+            timemory_end_record(_ids[j - 1]);
+    }
+    duration_t _single = clock_type::now() - _beg;
+
+    _beg = clock_type::now();
+    for(int i = 0; i < nitr; ++i)
+    {
+        timemory_begin_records(_names.size(), _names.data(), _ids.data());
+        timemory_end_records(_ids.size(), _ids.data());
+    }
+    duration_t _batch = clock_type::now() - _beg;
+
+    printf("begin/end %i records: %.3f nsec (single) vs. %.3f nsec (batch)\n\n",
+           (int) _names.size(), _single.count() / nitr, _batch.count() / nitr);
+
+    ASSERT_EQ(get_wc_storage_size(), wc_n);
+    ASSERT_EQ(get_pr_storage_size(), pr_n);
+}
+
+//--------------------------------------------------------------------------------------//
+
 TEST_F(library_tests, add)
 {
     timemory_push_components("wall_clock, cpu_util");
@@ -592,6 +798,26 @@ TEST_F(library_tests, pause_resume)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(library_tests, memory_usage)
+{
+    uint64_t idx = 0;
+
+    timemory_begin_record_enum(TEST_NAME, &idx, WALL_CLOCK, TIMEMORY_COMPONENTS_END);
+    ret += details::fibonacci(35);
+    timemory_end_record(idx);
+
+    printf("fibonacci(35) = %li\n\n", ret);
+
+    auto _total = timemory_get_memory_usage();
+    auto _wc    = timemory_get_component_memory_usage(WALL_CLOCK);
+
+    EXPECT_GT(_wc, 0);
+    EXPECT_GE(_total, _wc);
+    EXPECT_EQ(timemory_get_component_memory_usage(PAPI_ARRAY), 0);
+}
+
+//--------------------------------------------------------------------------------------//
+
 #include "timemory/environment.hpp"
 
 //--------------------------------------------------------------------------------------//
@@ -284,6 +284,38 @@ TEST_F(macro_tests, handle)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(macro_tests, static_hash)
+{
+    constexpr auto _compile_hash = tim::hash_type{}("macro_tests/static_hash");
+    static_assert(_compile_hash != 0, "compile-time hash should be non-zero");
+
+    std::string _label    = "macro_tests/static_hash";
+    auto        _run_hash = tim::get_hash_id(_label);
+    EXPECT_EQ(_compile_hash, _run_hash);
+    EXPECT_EQ(tim::get_hash_id(_label.c_str()), _run_hash);
+
+    for(int i = 0; i < 4; ++i)
+    {
+        auto_tuple_t _obj{ TIMEMORY_STATIC_HASH_ID("macro_tests/static_hash") };
+        EXPECT_EQ(_obj.hash(), _compile_hash);
+        details::consume(5);
+        _obj.stop();
+        EXPECT_EQ(_obj.key(), _label);
+    }
+
+    EXPECT_EQ(tim::get_hash_identifier(_compile_hash), _label);
+
+    // the label is registered once for the process so the other threads find it
+    auto _size = tim::get_hash_ids()->size();
+    std::thread{ [&]() {
+        EXPECT_EQ(TIMEMORY_STATIC_HASH_ID("macro_tests/static_hash"), _compile_hash);
+        EXPECT_EQ(tim::get_hash_identifier(_compile_hash), _label);
+    } }.join();
+    EXPECT_EQ(tim::get_hash_ids()->size(), _size);
+}
+
+//--------------------------------------------------------------------------------------//
+
 int
 main(int argc, char** argv)
 {
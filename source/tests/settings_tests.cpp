@@ -327,3 +327,66 @@ TEST_F(settings_tests, metadata)
 }
 
 //--------------------------------------------------------------------------------------//
+
+TEST_F(settings_tests, hot_data)
+{
+    auto* _settings = tim::settings::instance();
+
+    // the accessors reference the value of the entry in the map
+    EXPECT_EQ(&tim::settings::enabled(), &_settings->get_enabled());
+    EXPECT_EQ(_settings->get<int>(TIMEMORY_SETTINGS_KEY("VERBOSE")),
+              tim::settings::verbose());
+
+    // modifications through the map are seen by the accessors
+    auto _throttle = tim::settings::throttle_count();
+    EXPECT_TRUE(_settings->set(TIMEMORY_SETTINGS_KEY("THROTTLE_COUNT"), _throttle + 1));
+    EXPECT_EQ(tim::settings::throttle_count(), _throttle + 1);
+    tim::settings::throttle_count() = _throttle;
+    EXPECT_EQ(_settings->get<size_t>(TIMEMORY_SETTINGS_KEY("THROTTLE_COUNT")),
+              _throttle);
+
+    // a copy references its own entries
+    tim::settings _copy{ *_settings };
+    _copy.get_max_depth() = 3;
+    EXPECT_NE(&_copy.get_max_depth(), &tim::settings::max_depth());
+    EXPECT_EQ(_copy.get<uint16_t>(TIMEMORY_SETTINGS_KEY("MAX_DEPTH")), 3);
+    EXPECT_NE(tim::settings::max_depth(), 3);
+
+    // the cost of the queries made per event
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double, std::nano>;
+
+    constexpr int64_t nitr  = 1000000;
+    int64_t           _nhot = 0;
+    int64_t           _nmap = 0;
+
+    auto _beg = clock_type::now();
+    for(int64_t i = 0; i < nitr; ++i)
+    {
+        _nhot += (tim::settings::enabled() && !tim::settings::debug()) ? 1 : 0;
+        _nhot += tim::settings::verbose() + tim::settings::throttle_count();
+    }
+    duration_t _hot = clock_type::now() - _beg;
+
+    _beg = clock_type::now();
+    for(int64_t i = 0; i < nitr; ++i)
+    {
+        auto _shared = tim::settings::shared_instance();
+        _nmap += (_shared->get<bool>(TIMEMORY_SETTINGS_KEY("ENABLED")) &&
+                  !_shared->get<bool>(TIMEMORY_SETTINGS_KEY("DEBUG")))
+                     ? 1
+                     : 0;
+        _nmap += _shared->get<int>(TIMEMORY_SETTINGS_KEY("VERBOSE")) +
+                 _shared->get<size_t>(TIMEMORY_SETTINGS_KEY("THROTTLE_COUNT"));
+    }
+    duration_t _map = clock_type::now() - _beg;
+
+    std::cout << "\nsettings per event: " << std::setprecision(3) << std::fixed
+              << (_hot.count() / nitr) << " nsec (hot data) vs. "
+              << (_map.count() / nitr) << " nsec (map lookup)\n"
+              << std::endl;
+
+    EXPECT_EQ(_nhot, _nmap);
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,1448 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "test_macros.hpp"
+
+TIMEMORY_TEST_DEFAULT_MAIN
+
+#include "timemory/storage/chrome_trace.hpp"
+#include "timemory/timemory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_UNIX)
+#    include <dirent.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+using namespace tim::component;
+
+using bundle_t     = tim::component_tuple<wall_clock>;
+using storage_t    = tim::storage<wall_clock>;
+using iterator_t   = typename storage_t::iterator;
+using node_index_t = tim::node_index<int64_t>;
+using nested_map_t = std::unordered_map<int64_t, std::unordered_map<int64_t, int64_t>>;
+using key_vector_t = std::vector<std::pair<int64_t, int64_t>>;
+
+static const int64_t nwidth = 4096;
+static const int64_t ndepth = 256;
+static const int64_t nreps  = 200;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return std::string(::testing::UnitTest::GetInstance()->current_test_suite()->name()) +
+           "." + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// the (depth, hash) keys of a call-graph which is one level deep and nwidth wide
+inline key_vector_t
+get_wide_keys()
+{
+    key_vector_t _keys{};
+    for(int64_t i = 0; i < nwidth; ++i)
+        _keys.emplace_back(1, std::hash<std::string>{}(std::to_string(i)));
+    return _keys;
+}
+
+// the (depth, hash) keys of a call-graph which is ndepth deep and one node wide
+inline key_vector_t
+get_deep_keys()
+{
+    key_vector_t _keys{};
+    for(int64_t i = 0; i < ndepth; ++i)
+        _keys.emplace_back(i + 1, std::hash<std::string>{}(std::to_string(i)));
+    return _keys;
+}
+
+// mimics the lookup pattern of the insert paths: find the entry and insert on a miss
+inline int64_t
+find_or_insert(nested_map_t& _map, int64_t _depth, int64_t _hash)
+{
+    auto _itr = _map[_depth].find(_hash);
+    if(_itr != _map[_depth].end())
+        return _itr->second;
+    return (_map[_depth][_hash] = _hash);
+}
+
+inline int64_t
+find_or_insert(node_index_t& _map, int64_t _depth, int64_t _hash)
+{
+    auto _itr = _map.emplace(_depth, _hash);
+    if(!_itr.second)
+        return *_itr.first;
+    return (*_itr.first = _hash);
+}
+
+// measure the average latency (nanoseconds) of a find-or-insert
+template <typename MapT>
+double
+benchmark(const std::string& _label, const key_vector_t& _keys)
+{
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double, std::nano>;
+
+    MapT    _map{};
+    int64_t _sum = 0;
+    auto    _beg = clock_type::now();
+    for(int64_t i = 0; i < nreps; ++i)
+    {
+        for(const auto& itr : _keys)
+            _sum += find_or_insert(_map, itr.first, itr.second);
+    }
+    duration_t _elapsed = clock_type::now() - _beg;
+
+    auto _latency = _elapsed.count() / (nreps * _keys.size());
+    std::cout << std::setw(24) << _label << " : " << std::setw(10) << std::setprecision(3)
+              << std::fixed << _latency << " nsec/insert (" << (_sum % 10) << ")"
+              << std::endl;
+    return _latency;
+}
+
+// start and stop a bundle for every label (entries at the same depth)
+inline void
+wide(const std::vector<std::string>& _labels)
+{
+    for(const auto& itr : _labels)
+    {
+        bundle_t _obj{ itr };
+        _obj.start();
+        _obj.stop();
+    }
+}
+
+// start a bundle for every label and stop them in reverse (entries at every depth)
+inline void
+deep(const std::vector<std::string>& _labels)
+{
+    std::vector<bundle_t> _objs{};
+    _objs.reserve(_labels.size());
+    for(const auto& itr : _labels)
+    {
+        _objs.emplace_back(itr);
+        _objs.back().start();
+    }
+    for(auto itr = _objs.rbegin(); itr != _objs.rend(); ++itr)
+        itr->stop();
+}
+
+// measure the average latency (nanoseconds) of a start/stop pair in the storage
+template <typename FuncT>
+double
+benchmark_storage(const std::string& _label, FuncT&& _func,
+                  const std::vector<std::string>& _labels)
+{
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double, std::nano>;
+
+    auto _beg = clock_type::now();
+    for(int64_t i = 0; i < nreps / 10; ++i)
+        _func(_labels);
+    duration_t _elapsed = clock_type::now() - _beg;
+
+    auto _latency = _elapsed.count() / ((nreps / 10) * _labels.size());
+    std::cout << std::setw(24) << _label << " : " << std::setw(10) << std::setprecision(3)
+              << std::fixed << _latency << " nsec/insert" << std::endl;
+    return _latency;
+}
+
+inline std::vector<std::string>
+get_labels(const std::string& _prefix, int64_t _n)
+{
+    std::vector<std::string> _labels{};
+    for(int64_t i = 0; i < _n; ++i)
+        _labels.emplace_back(_prefix + "/" + std::to_string(i));
+    return _labels;
+}
+
+// records a call-graph on _nworkers threads which are kept alive while their storage
+// is merged into the master with _nmerge threads (zero uses the per-worker merge)
+inline double
+benchmark_merge(const std::string& _label, int64_t _nworkers, size_t _nmerge)
+{
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double, std::milli>;
+    using merge_t    = tim::operation::finalize::merge<wall_clock, true>;
+    using impl_t     = tim::impl::storage<wall_clock, true>;
+
+    auto _labels = get_labels(_label, 64);
+
+    std::atomic<int64_t> _ready{ 0 };
+    std::promise<void>   _release{};
+    auto                 _released = _release.get_future().share();
+
+    auto _worker = [&]() {
+        for(const auto& itr : _labels)
+        {
+            bundle_t _outer{ itr };
+            _outer.start();
+            for(int64_t i = 0; i < 4; ++i)
+            {
+                bundle_t _inner{ _labels.at(i) };
+                _inner.start();
+                _inner.stop();
+            }
+            _outer.stop();
+        }
+        ++_ready;
+        _released.wait();
+    };
+
+    std::vector<std::thread> _threads{};
+    for(int64_t i = 0; i < _nworkers; ++i)
+        _threads.emplace_back(_worker);
+    while(_ready.load() < _nworkers)
+        std::this_thread::yield();
+
+    impl_t*              _master = storage_t::instance();
+    std::vector<impl_t*> _children{};
+    for(auto* itr : impl_t::singleton_type::children())
+    {
+        if(itr != _master)
+            _children.emplace_back(itr);
+    }
+
+    auto _beg = clock_type::now();
+    if(_nmerge == 0)
+    {
+        for(auto* itr : _children)
+            merge_t(*_master, *itr);
+    }
+    else
+    {
+        merge_t(*_master, _children, _nmerge);
+    }
+    duration_t _elapsed = clock_type::now() - _beg;
+
+    _release.set_value();
+    for(auto& itr : _threads)
+        itr.join();
+
+    std::cout << std::setw(24) << _label << " : " << std::setw(4) << _nworkers
+              << " workers, " << std::setw(2) << _nmerge << " merge threads : "
+              << std::setw(10) << std::setprecision(3) << std::fixed << _elapsed.count()
+              << " msec" << std::endl;
+    return _elapsed.count();
+}
+
+#if defined(_UNIX)
+// the names of the regular files in a directory
+inline std::set<std::string>
+list_files(const std::string& _dir)
+{
+    std::set<std::string> _files{};
+    if(DIR* _d = opendir(_dir.c_str()))
+    {
+        while(dirent* _e = readdir(_d))
+        {
+            if(_e->d_type == DT_REG)
+                _files.emplace(_e->d_name);
+        }
+        closedir(_d);
+    }
+    return _files;
+}
+
+inline std::string
+read_file(const std::string& _fname)
+{
+    std::ifstream     _ifs{ _fname, std::ios::in | std::ios::binary };
+    std::stringstream _ss{};
+    _ss << _ifs.rdbuf();
+    return _ss.str();
+}
+
+inline void
+remove_dir(const std::string& _dir)
+{
+    for(const auto& itr : list_files(_dir))
+        unlink((_dir + "/" + itr).c_str());
+    rmdir(_dir.c_str());
+}
+
+// finalize a copy of this process which writes the output files to a directory and
+// the console output to a file. The copies finalize the same measurements so the
+// output only depends on the settings
+inline void
+finalize_copy(size_t _nthreads, const std::string& _dir, const std::string& _cout)
+{
+    fflush(stdout);
+    std::cout << std::flush;
+    auto _pid = fork();
+    ASSERT_GE(_pid, 0);
+    if(_pid == 0)
+    {
+        if(!freopen(_cout.c_str(), "w", stdout))
+            _exit(EXIT_FAILURE);
+        tim::settings::output_path()     = _dir;
+        tim::settings::parallel_output() = _nthreads;
+        // the objects which are still running would be stopped with new values
+        tim::settings::stack_clearing() = false;
+        tim::timemory_finalize();
+        std::cout << std::flush;
+        fflush(stdout);
+        _exit(EXIT_SUCCESS);
+    }
+    int _status = 0;
+    waitpid(_pid, &_status, 0);
+    ASSERT_TRUE(WIFEXITED(_status)) << _dir;
+    ASSERT_EQ(WEXITSTATUS(_status), EXIT_SUCCESS) << _dir;
+}
+#endif
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class storage_tests : public ::testing::Test
+{
+protected:
+    TIMEMORY_TEST_DEFAULT_SUITE_BODY
+};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, node_index)
+{
+    std::mt19937_64 _rng{ 1234 };
+    std::uniform_int_distribution<int64_t> _depth_dist{ 0, 16 };
+    std::uniform_int_distribution<int64_t> _hash_dist{ 0, 512 };
+
+    node_index_t                                   _index{};
+    std::map<std::pair<int64_t, int64_t>, int64_t> _reference{};
+    for(int64_t i = 0; i < 10000; ++i)
+    {
+        auto _depth = _depth_dist(_rng);
+        auto _hash  = _hash_dist(_rng);
+        auto _ret   = _index.emplace(_depth, _hash);
+        auto _ref   = _reference.emplace(std::make_pair(_depth, _hash), i);
+        EXPECT_EQ(_ret.second, _ref.second) << details::get_test_name();
+        if(_ret.second)
+            *_ret.first = i;
+        EXPECT_EQ(*_ret.first, _ref.first->second) << details::get_test_name();
+    }
+
+    EXPECT_EQ(_index.size(), _reference.size());
+    EXPECT_GE(_index.capacity(), 2 * _index.size());
+    for(const auto& itr : _reference)
+    {
+        auto* _val = _index.find(itr.first.first, itr.first.second);
+        ASSERT_NE(_val, nullptr) << details::get_test_name();
+        EXPECT_EQ(*_val, itr.second);
+    }
+    EXPECT_EQ(_index.find(-1, 0), nullptr);
+
+    // reset-style erase: keep only the (0, 0) entry
+    _index.insert(0, 0, -1);
+    _index.erase_if([](int64_t _depth, int64_t _hash, int64_t) {
+        return _depth != 0 || _hash != 0;
+    });
+    EXPECT_EQ(_index.size(), static_cast<size_t>(1));
+    ASSERT_NE(_index.find(0, 0), nullptr);
+    EXPECT_EQ(*_index.find(0, 0), -1);
+    EXPECT_EQ(_index.find(1, 1), nullptr);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, reset)
+{
+    auto _wide  = details::get_labels(details::get_test_name() + "/wide", 32);
+    auto _deep  = details::get_labels(details::get_test_name() + "/deep", 32);
+    auto _bsize = storage_t::instance()->size();
+
+    details::wide(_wide);
+    details::deep(_deep);
+
+    auto _esize = storage_t::instance()->size();
+    EXPECT_EQ(_esize - _bsize, _wide.size() + _deep.size());
+
+    // the cached node iterators must not outlive the nodes
+    storage_t::instance()->reset();
+    EXPECT_EQ(storage_t::instance()->size(), static_cast<size_t>(0));
+
+    details::wide(_wide);
+    details::deep(_deep);
+    details::wide(_wide);
+
+    EXPECT_EQ(storage_t::instance()->size(), _wide.size() + _deep.size());
+    auto _data = storage_t::instance()->get();
+    ASSERT_EQ(_data.size(), _wide.size() + _deep.size());
+    for(size_t i = 0; i < _wide.size(); ++i)
+    {
+        EXPECT_EQ(_data.at(i).depth(), 0) << details::get_test_name();
+        EXPECT_EQ(_data.at(i).data().get_laps(), 2) << details::get_test_name();
+    }
+    for(size_t i = 0; i < _deep.size(); ++i)
+    {
+        EXPECT_EQ(_data.at(i + _wide.size()).depth(), static_cast<int64_t>(i))
+            << details::get_test_name();
+        EXPECT_EQ(_data.at(i + _wide.size()).data().get_laps(), 1)
+            << details::get_test_name();
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, flat_reset)
+{
+    using graph_t = typename storage_t::graph_t;
+
+    auto _labels = details::get_labels(details::get_test_name(), 8);
+    auto _flat   = [&_labels]() {
+        for(const auto& itr : _labels)
+        {
+            bundle_t _obj{ itr, tim::quirk::config<tim::quirk::flat_scope>{} };
+            _obj.start();
+            _obj.stop();
+        }
+    };
+
+    _flat();
+    storage_t::instance()->reset();
+    EXPECT_EQ(storage_t::instance()->size(), static_cast<size_t>(0));
+
+    // the flat insertion point must not refer to a node erased by the reset
+    _flat();
+    _flat();
+
+    EXPECT_EQ(storage_t::instance()->size(), _labels.size());
+    auto& _graph = storage_t::instance()->graph();
+    for(auto itr = _graph.begin(); itr != _graph.end(); ++itr)
+        EXPECT_NE(graph_t::parent(itr), itr) << details::get_test_name();
+
+    auto _data = storage_t::instance()->get();
+    ASSERT_EQ(_data.size(), _labels.size());
+    for(const auto& itr : _data)
+        EXPECT_EQ(itr.data().get_laps(), 2) << itr.prefix();
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, child_hint)
+{
+    auto    _labels = details::get_labels(details::get_test_name(), 3);
+    int64_t _nloop  = 1000;
+
+    bundle_t _parent{ _labels.at(0) };
+    _parent.start();
+
+    auto _bsize   = storage_t::instance()->size();
+    auto _bhits   = storage_t::instance()->child_hint_hits();
+    auto _bmisses = storage_t::instance()->child_hint_misses();
+
+    // re-entering the same child is resolved by the hint
+    for(int i = 0; i < _nloop; ++i)
+    {
+        bundle_t _obj{ _labels.at(1) };
+        _obj.start();
+        _obj.stop();
+    }
+
+    EXPECT_EQ(storage_t::instance()->child_hint_hits() - _bhits,
+              static_cast<uint64_t>(_nloop - 1));
+    EXPECT_EQ(storage_t::instance()->child_hint_misses() - _bmisses,
+              static_cast<uint64_t>(1));
+
+    // alternating between children still locates the correct node
+    for(int i = 0; i < _nloop; ++i)
+    {
+        bundle_t _obj{ _labels.at(1 + (i % 2)) };
+        _obj.start();
+        _obj.stop();
+    }
+
+    _parent.stop();
+
+    EXPECT_EQ(storage_t::instance()->size() - _bsize, static_cast<size_t>(2));
+
+    auto _data   = storage_t::instance()->get();
+    auto _nfound = 0;
+    for(auto& itr : _data)
+    {
+        if(itr.prefix().find(_labels.at(1)) != std::string::npos)
+        {
+            EXPECT_EQ(itr.data().get_laps(), _nloop + _nloop / 2) << itr.prefix();
+            EXPECT_EQ(itr.depth(), 1) << itr.prefix();
+            ++_nfound;
+        }
+        else if(itr.prefix().find(_labels.at(2)) != std::string::npos)
+        {
+            EXPECT_EQ(itr.data().get_laps(), _nloop / 2) << itr.prefix();
+            EXPECT_EQ(itr.depth(), 1) << itr.prefix();
+            ++_nfound;
+        }
+    }
+    EXPECT_EQ(_nfound, 2);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, incremental_merge)
+{
+    auto    _labels   = details::get_labels(details::get_test_name(), 3);
+    int64_t _nthreads = 8;
+    int64_t _nloop    = 10;
+    auto    _incr     = tim::settings::incremental_merge();
+
+    tim::settings::incremental_merge() = true;
+
+    bundle_t _parent{ _labels.at(0) };
+    _parent.start();
+
+    auto _bsize = storage_t::instance()->size();
+
+    auto _worker = [&]() {
+        for(int64_t i = 0; i < _nloop; ++i)
+        {
+            bundle_t _outer{ _labels.at(1) };
+            _outer.start();
+            bundle_t _inner{ _labels.at(2) };
+            _inner.start();
+            _inner.stop();
+            _outer.stop();
+        }
+    };
+
+    std::vector<std::thread> _threads{};
+    for(int64_t i = 0; i < _nthreads; ++i)
+        _threads.emplace_back(_worker);
+    for(auto& itr : _threads)
+        itr.join();
+
+    _parent.stop();
+
+    // the worker graphs were folded into the aggregate and released at thread exit
+    // so nothing has been appended to the graph of the master yet
+    EXPECT_EQ(storage_t::instance()->size(), _bsize) << details::get_test_name();
+
+    auto _data = storage_t::instance()->get();
+
+    // one node per unique call-path instead of one per thread per call-path
+    EXPECT_EQ(storage_t::instance()->size() - _bsize, static_cast<size_t>(2))
+        << details::get_test_name();
+
+    auto _nfound = 0;
+    for(auto& itr : _data)
+    {
+        if(itr.prefix().find(_labels.at(1)) != std::string::npos ||
+           itr.prefix().find(_labels.at(2)) != std::string::npos)
+        {
+            EXPECT_EQ(itr.data().get_laps(), _nthreads * _nloop) << itr.prefix();
+            ++_nfound;
+        }
+    }
+    EXPECT_EQ(_nfound, 2);
+
+    tim::settings::incremental_merge() = _incr;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, node_limit)
+{
+    auto    _labels = details::get_labels(details::get_test_name(), 11);
+    auto    _limit  = tim::settings::thread_node_limit();
+    int64_t _nextra = 4;
+
+    bundle_t _parent{ _labels.at(0) };
+    _parent.start();
+
+    auto _bsize   = storage_t::instance()->size();
+    auto _bfolded = storage_t::instance()->folded_inserts();
+
+    tim::settings::thread_node_limit() = storage_t::instance()->node_count() + _nextra;
+
+    for(int i = 0; i < 2; ++i)
+    {
+        for(size_t j = 1; j < _labels.size(); ++j)
+        {
+            bundle_t _obj{ _labels.at(j) };
+            _obj.start();
+            _obj.stop();
+        }
+    }
+
+    _parent.stop();
+
+    tim::settings::thread_node_limit() = _limit;
+
+    // the first entries fill the budget, the rest go into one [other] node
+    auto _nfolded = 2 * (_labels.size() - 1 - _nextra);
+    EXPECT_EQ(storage_t::instance()->size() - _bsize, static_cast<size_t>(_nextra + 1))
+        << details::get_test_name();
+    EXPECT_EQ(storage_t::instance()->folded_inserts() - _bfolded,
+              static_cast<uint64_t>(_nfolded))
+        << details::get_test_name();
+
+    auto _data   = storage_t::instance()->get();
+    auto _nfound = 0;
+    for(auto& itr : _data)
+    {
+        if(itr.prefix().find("[other]") == std::string::npos)
+            continue;
+        ++_nfound;
+        EXPECT_EQ(itr.data().get_laps(), static_cast<int64_t>(_nfolded)) << itr.prefix();
+    }
+    EXPECT_EQ(_nfound, 1);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, snapshot_layout)
+{
+    using snapshot_t = tim::storage_snapshot<wall_clock>;
+
+    auto _labels = details::get_labels(details::get_test_name(), 256);
+
+    bundle_t _parent{ details::get_test_name() };
+    _parent.start();
+    for(const auto& itr : _labels)
+    {
+        bundle_t _outer{ itr };
+        _outer.start();
+        for(size_t i = 0; i < 4; ++i)
+        {
+            bundle_t _inner{ _labels.at(i) };
+            _inner.start();
+            _inner.stop();
+        }
+        _outer.stop();
+    }
+    // the copy does not recurse so the depth of the graph is not limited by the stack
+    details::deep(details::get_labels(details::get_test_name() + "/deep", 4096));
+    _parent.stop();
+
+    auto& _graph    = storage_t::instance()->graph();
+    auto  _snapshot = storage_t::instance()->snapshot();
+
+    ASSERT_EQ(_snapshot.size(), _graph.size()) << details::get_test_name();
+
+    // the nodes are stored in pre-order
+    int64_t _idx = 0;
+    for(auto itr = _graph.begin(); itr != _graph.end(); ++itr, ++_idx)
+    {
+        EXPECT_EQ(_snapshot.id().at(_idx), itr->id());
+        EXPECT_EQ(_snapshot.depth().at(_idx), itr->depth());
+        EXPECT_EQ(_snapshot.laps().at(_idx), itr->obj().get_laps());
+        EXPECT_EQ(_snapshot.accum().at(_idx), itr->obj().get_accum());
+        EXPECT_EQ(_snapshot.get(_idx).get_laps(), itr->obj().get_laps());
+        auto _parent_itr = storage_t::graph_t::parent(itr);
+        auto _parent_idx = _snapshot.parent().at(_idx);
+        if(_parent_idx == snapshot_t::npos)
+            EXPECT_FALSE(_graph.is_valid(_parent_itr));
+        else
+            EXPECT_EQ(_snapshot.id().at(_parent_idx), _parent_itr->id());
+    }
+
+    // the children of each node are linked in the same order as the graph
+    _idx = 0;
+    for(auto itr = _graph.begin(); itr != _graph.end(); ++itr, ++_idx)
+    {
+        std::vector<uint64_t> _children{};
+        for(auto citr = itr.begin(); citr != itr.end(); ++citr)
+            _children.emplace_back(citr->id());
+        std::vector<uint64_t> _snapshot_children{};
+        _snapshot.for_each_child(_idx, [&](int32_t _child) {
+            _snapshot_children.emplace_back(_snapshot.id().at(_child));
+        });
+        EXPECT_EQ(_snapshot_children, _children);
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, snapshot)
+{
+    using snapshot_t = tim::storage_snapshot<wall_clock>;
+    using impl_t     = tim::impl::storage<wall_clock, true>;
+
+    auto _labels = details::get_labels(details::get_test_name(), 512);
+
+    std::atomic<bool>       _stop{ false };
+    std::atomic<impl_t*>    _worker{ nullptr };
+    std::atomic<size_t>     _iterations{ 0 };
+
+    // the worker keeps creating new nodes while the snapshots are taken
+    std::thread _thread([&]() {
+        _worker.store(storage_t::instance());
+        bundle_t _parent{ details::get_test_name() };
+        _parent.start();
+        while(!_stop.load())
+        {
+            for(const auto& itr : _labels)
+            {
+                bundle_t _outer{ itr };
+                _outer.start();
+                bundle_t _inner{ _labels.at(_iterations % _labels.size()) };
+                _inner.start();
+                _inner.stop();
+                _outer.stop();
+            }
+            ++_iterations;
+        }
+        _parent.stop();
+    });
+
+    while(!_worker.load())
+        std::this_thread::yield();
+
+    size_t  _size = 0;
+    int64_t _laps = 0;
+    for(size_t i = 0; i < 200; ++i)
+    {
+        // let the graph grow between the snapshots (the worker completes 20 iterations)
+        while(_iterations.load() < i / 10)
+            std::this_thread::yield();
+
+        auto _snapshot = _worker.load()->snapshot();
+        ASSERT_GE(_snapshot.size(), _size) << details::get_test_name();
+        _size = _snapshot.size();
+
+        // the topology is consistent: every parent precedes its children and every
+        // child is reachable from its parent
+        size_t _nchild = 0;
+        size_t _nroot  = 0;
+        for(size_t j = 0; j < _snapshot.size(); ++j)
+        {
+            auto _idx    = static_cast<snapshot_t::index_type>(j);
+            auto _parent = _snapshot.parent().at(j);
+            if(_parent == snapshot_t::npos)
+                ++_nroot;
+            else
+                ASSERT_LT(_parent, _idx);
+            _snapshot.for_each_child(_idx, [&](int32_t _child) {
+                EXPECT_EQ(_snapshot.parent().at(_child), _idx);
+                ++_nchild;
+            });
+        }
+        EXPECT_EQ(_nchild + _nroot, _snapshot.size());
+
+        int64_t _total = 0;
+        for(const auto& itr : _snapshot.laps())
+            _total += itr;
+        EXPECT_GE(_total, _laps);
+        _laps = _total;
+    }
+
+    auto _snapshots = storage_t::instance()->snapshots();
+    EXPECT_GE(_snapshots.size(), 2) << details::get_test_name();
+
+    _stop.store(true);
+    _thread.join();
+
+    std::cout << "[" << details::get_test_name() << "]> " << _size
+              << " nodes in the last snapshot after " << _iterations.load()
+              << " worker iterations" << std::endl;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, snapshot_pause)
+{
+    using node_t       = tim::node::graph<wall_clock>;
+    using graph_data_t = tim::graph_data<node_t>;
+    using clock_type   = std::chrono::steady_clock;
+    using duration_t   = std::chrono::duration<double, std::milli>;
+
+    graph_data_t _data{ node_t{ 0, wall_clock{}, 0, 0 }, 0 };
+
+    // a modification waits until a (slow) read in progress completes so the read never
+    // sees the graph change
+    std::atomic<bool> _reading{ false };
+    size_t            _before = 0;
+    size_t            _after  = 0;
+    auto              _reader = std::async(std::launch::async, [&]() {
+        return _data.read([&](const graph_data_t::graph_t& _graph) {
+            _before = _graph.size();
+            _reading.store(true);
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 200 });
+            _after = _graph.size();
+        });
+    });
+
+    while(!_reading.load())
+        std::this_thread::yield();
+
+    node_t _node{ 1, wall_clock{}, 1, 0 };
+    auto   _beg = clock_type::now();
+    _data.append_head(_node);
+    auto _pause = duration_t{ clock_type::now() - _beg }.count();
+
+    EXPECT_EQ(_reader.get(), 1) << details::get_test_name();
+    EXPECT_EQ(_before, _after) << details::get_test_name();
+    EXPECT_EQ(_data.graph().size(), _after + 1) << details::get_test_name();
+
+    // a read which is invalidated repeatedly makes the modifications wait so that it
+    // completes while the graph is modified continuously
+    std::atomic<bool> _stop{ false };
+    std::thread       _writer([&]() {
+        uint64_t _n = 2;
+        while(!_stop.load())
+        {
+            node_t _child{ _n++, wall_clock{}, 1, 0 };
+            _data.append_head(_child);
+        }
+    });
+
+    size_t _size     = 0;
+    auto   _attempts = _data.read([&](const graph_data_t::graph_t& _graph) {
+        _size = 0;
+        for(auto itr = _graph.begin(); itr != _graph.end(); ++itr)
+            ++_size;
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    });
+
+    _stop.store(true);
+    _writer.join();
+
+    EXPECT_GE(_size, 2) << details::get_test_name();
+    std::cout << "[" << details::get_test_name() << "]> " << _pause
+              << " msec pause of the modification, " << _attempts
+              << " attempts of the read while modified continuously" << std::endl;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, usage)
+{
+    using manager_t = tim::manager::get_storage<wall_clock>;
+
+    auto _init = storage_t::instance()->usage();
+    details::deep(details::get_labels(details::get_test_name(), 64));
+    details::wide(details::get_labels(details::get_test_name(), 2048));
+    auto _usage = storage_t::instance()->usage();
+
+    EXPECT_EQ(_usage.tid, tim::threading::get_id());
+    EXPECT_GT(_usage.graph, _init.graph);
+    EXPECT_GE(_usage.node_ids, _init.node_ids);
+    EXPECT_GT(_usage.hash_ids, _init.hash_ids);
+    EXPECT_EQ(_usage.total(), _usage.entries().at("total"));
+
+    // the worker is reported separately while it is alive
+    std::promise<void> _release{};
+    std::promise<void> _ready{};
+    std::thread        _thread([&]() {
+        details::wide(details::get_labels(details::get_test_name(), 64));
+        _ready.set_value();
+        _release.get_future().wait();
+    });
+    _ready.get_future().wait();
+
+    auto _usages = storage_t::usages();
+    ASSERT_GE(_usages.size(), 2) << details::get_test_name();
+    EXPECT_EQ(_usages.front().tid, tim::threading::get_id());
+    uint64_t _sum = 0;
+    for(const auto& itr : _usages)
+        _sum += itr.graph;
+
+    auto _types = manager_t::usage({}, { tim::component::properties<wall_clock>{}() });
+    ASSERT_EQ(_types.size(), 1) << details::get_test_name();
+    EXPECT_EQ(_types.begin()->second.size(), _usages.size());
+    EXPECT_EQ(manager_t::usage().graph, _sum);
+
+    _release.set_value();
+    _thread.join();
+
+    for(const auto& itr : _usages)
+    {
+        std::cout << "[" << details::get_test_name() << "]> thread " << itr.tid << " :";
+        for(const auto& eitr : itr.entries())
+            std::cout << " " << eitr.first << " = " << eitr.second;
+        std::cout << std::endl;
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, usage_concurrent)
+{
+    constexpr size_t nthreads = 4;
+
+    // the workers insert new nodes until they are released
+    std::atomic<bool>    _done{ false };
+    std::atomic<size_t>  _ready{ 0 };
+    std::vector<int64_t> _tids(nthreads, -1);
+    auto                 _run = [&](size_t _idx) {
+        _tids.at(_idx) = tim::threading::get_id();
+        ++_ready;
+        for(int64_t i = 0; !_done.load(); ++i)
+        {
+            auto _labels = details::get_labels(details::get_test_name() + "/" +
+                                                   std::to_string(_idx) + "/" +
+                                                   std::to_string(i),
+                                               8);
+            details::deep(_labels);
+            details::wide(_labels);
+        }
+    };
+
+    std::vector<std::thread> _threads{};
+    for(size_t i = 0; i < nthreads; ++i)
+        _threads.emplace_back(_run, i);
+    while(_ready.load() < nthreads)
+        std::this_thread::yield();
+
+    // the graph of a worker only grows while it inserts
+    std::map<int64_t, uint64_t> _last{};
+    size_t                      _nread = 0;
+    auto _end = std::chrono::steady_clock::now() + std::chrono::milliseconds{ 250 };
+    while(std::chrono::steady_clock::now() < _end)
+    {
+        for(const auto& itr : storage_t::usages())
+        {
+            if(std::find(_tids.begin(), _tids.end(), itr.tid) == _tids.end())
+                continue;
+            EXPECT_GE(itr.graph, _last[itr.tid]) << "thread " << itr.tid;
+            EXPECT_EQ(itr.total(), itr.entries().at("total"));
+            _last[itr.tid] = itr.graph;
+        }
+        ++_nread;
+    }
+
+    _done.store(true);
+    for(auto& itr : _threads)
+        itr.join();
+
+    EXPECT_GT(_nread, 0);
+    EXPECT_EQ(_last.size(), nthreads);
+    for(const auto& itr : _last)
+        EXPECT_GT(itr.second, 0) << "thread " << itr.first;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, collapse)
+{
+    auto _labels    = details::get_labels(details::get_test_name(), 13);
+    auto _threshold = tim::settings::collapse_threshold();
+    auto _min_laps  = tim::settings::collapse_min_laps();
+
+    // every node is cheap enough to collapse after 100 calls
+    tim::settings::collapse_threshold() = 1.0e6;
+    tim::settings::collapse_min_laps()  = 100;
+
+    auto _depth      = storage_t::instance()->depth();
+    auto _bcollapsed = storage_t::instance()->collapsed_inserts();
+    auto _record     = [&_labels](int64_t _n) {
+        for(int64_t i = 0; i < _n; ++i)
+        {
+            bundle_t _parent{ _labels.at(0) };
+            _parent.start();
+            for(size_t j = 1; j < 5; ++j)
+            {
+                bundle_t _child{ _labels.at(j) };
+                _child.start();
+                for(size_t k = 0; k < 10; ++k)
+                {
+                    bundle_t _leaf{ _labels.at(j + 4) };
+                    _leaf.start();
+                    bundle_t _nested{ _labels.at(j + 8) };
+                    _nested.start();
+                    _nested.stop();
+                    _leaf.stop();
+                }
+                _child.stop();
+            }
+            _parent.stop();
+        }
+    };
+
+    // the leaves and the calls nested in them reach 100 calls in the last record
+    _record(10);
+    auto _size  = storage_t::instance()->size();
+    auto _count = storage_t::instance()->collapsed_count();
+    _record(89);
+
+    tim::settings::collapse_threshold() = _threshold;
+    tim::settings::collapse_min_laps()  = _min_laps;
+
+    // the only new nodes are the [collapsed] children of the four children
+    EXPECT_EQ(storage_t::instance()->size(), _size + 4) << details::get_test_name();
+    EXPECT_EQ(storage_t::instance()->depth(), _depth) << details::get_test_name();
+    EXPECT_EQ(storage_t::instance()->collapsed_count(), _count) << details::get_test_name();
+    EXPECT_EQ(storage_t::instance()->collapsed_inserts() - _bcollapsed, 89 * 4 * 10 * 2)
+        << details::get_test_name();
+
+    // each leaf is folded into its parent: the leaf keeps its first 100 calls, the
+    // [collapsed] child of the parent has one lap per later call of the leaf and the
+    // calls nested in the leaf are not counted a second time
+    auto&   _graph     = storage_t::instance()->graph();
+    int64_t _nchild    = 0;
+    int64_t _ncollapse = 0;
+    for(auto itr = _graph.begin(); itr != _graph.end(); ++itr)
+    {
+        if(itr->obj().get_laps() != 99)
+            continue;
+        ++_nchild;
+        for(auto citr = itr.begin(); citr != itr.end(); ++citr)
+        {
+            if(citr->id() != tim::get_hash_id("[collapsed]"))
+            {
+                if(citr->obj().get_laps() != 99)
+                {
+                    EXPECT_EQ(citr->obj().get_laps(), 100) << details::get_test_name();
+                }
+                continue;
+            }
+            ++_ncollapse;
+            EXPECT_EQ(citr->obj().get_laps(), 89 * 10) << details::get_test_name();
+            EXPECT_LE(citr->obj().get_accum(), itr->obj().get_accum())
+                << details::get_test_name();
+        }
+    }
+    // the parent and the four children
+    EXPECT_EQ(_nchild, 5) << details::get_test_name();
+    EXPECT_EQ(_ncollapse, 4) << details::get_test_name();
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, hash_ids)
+{
+    constexpr size_t nthreads = 4;
+    constexpr size_t nlabels  = 2048;
+
+    auto& _hash_ids = tim::get_hash_ids();
+    auto  _init     = _hash_ids->size();
+
+    // every thread inserts an overlapping set of labels while looking up the labels
+    // inserted by the other threads
+    std::vector<const std::string*> _addr(nthreads * nlabels, nullptr);
+    std::vector<std::thread>        _threads{};
+    for(size_t i = 0; i < nthreads; ++i)
+    {
+        _threads.emplace_back([&, i]() {
+            EXPECT_EQ(tim::get_hash_ids(), _hash_ids);
+            for(size_t j = 0; j < nlabels; ++j)
+            {
+                auto _label = details::get_test_name() + "/" + std::to_string(j);
+                auto _hash  = tim::add_hash_id(_label);
+                auto _itr   = tim::get_hash_ids()->find(_hash);
+                ASSERT_NE(_itr, tim::get_hash_ids()->end());
+                EXPECT_EQ(_itr->second, _label);
+                _addr.at(i * nlabels + j) = &_itr->second;
+            }
+        });
+    }
+    for(auto& itr : _threads)
+        itr.join();
+
+    // the labels were stored once and never moved
+    EXPECT_EQ(_hash_ids->size(), _init + nlabels);
+    for(size_t j = 0; j < nlabels; ++j)
+    {
+        auto _label = details::get_test_name() + "/" + std::to_string(j);
+        auto _itr   = _hash_ids->find(tim::get_hash_id(_label));
+        ASSERT_NE(_itr, _hash_ids->end());
+        for(size_t i = 0; i < nthreads; ++i)
+            EXPECT_EQ(_addr.at(i * nlabels + j), &_itr->second);
+    }
+
+    size_t _n = 0;
+    _hash_ids->for_each([&_n](const auto&) { ++_n; });
+    EXPECT_EQ(_n, _hash_ids->size());
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, hash_aliases)
+{
+    using labels_t = std::vector<std::string>;
+
+    auto  _label   = details::get_test_name();
+    auto  _labels  = details::get_labels(_label, nwidth / 4);
+    auto& _aliases = tim::get_hash_aliases();
+
+    // the first pass creates the nodes and registers their aliases
+    details::wide(_labels);
+    auto _naliases = _aliases->size();
+
+    // the following passes locate the existing nodes without touching the alias table
+    auto _latency = details::benchmark_storage("wide (storage)", details::wide, _labels);
+    EXPECT_EQ(_aliases->size(), _naliases);
+
+    // the cost of the lookups which were previously repeated by every insert
+    std::vector<std::pair<uint64_t, uint64_t>> _ids{};
+    for(const auto& itr : _labels)
+        _ids.emplace_back(tim::get_hash_id(itr), tim::get_hash_id(itr) ^ 1);
+    for(const auto& itr : _ids)
+        tim::add_hash_id(itr.first, itr.second);
+    auto _lookup = details::benchmark_storage(
+        "wide (alias lookups)",
+        [&_ids](const labels_t&) {
+            for(const auto& itr : _ids)
+                tim::add_hash_id(itr.first, itr.second);
+        },
+        _labels);
+
+    std::cout << "\nalias lookups removed from insert: " << std::setprecision(3)
+              << _lookup << " nsec/insert (" << std::setprecision(1)
+              << (100.0 * _lookup / (_latency + _lookup)) << "%)\n"
+              << std::endl;
+
+    // the aliases registered at creation still resolve the labels of the nodes
+    auto _nfound = 0;
+    for(auto& itr : storage_t::instance()->get())
+    {
+        if(itr.prefix().find(_label + "/") == std::string::npos)
+            continue;
+        ++_nfound;
+        EXPECT_EQ(itr.data().get_laps(), 1 + nreps / 10) << itr.prefix();
+    }
+    EXPECT_EQ(_nfound, static_cast<int>(_labels.size()));
+    EXPECT_GT(_lookup, 0.0);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, event_trace)
+{
+    namespace event_trace = tim::event_trace;
+
+    auto _labels = details::get_labels(details::get_test_name(), 16);
+    auto _size   = storage_t::instance()->size();
+
+    event_trace::enabled() = true;
+    auto _run              = [&_labels]() {
+        details::deep(_labels);
+        details::wide(_labels);
+    };
+    std::thread _thread{ _run };
+    _run();
+    _thread.join();
+
+    // a component which is pushed, started and stopped repeatedly without a reset
+    // records each interval instead of its accumulated value
+    auto _reused = details::get_test_name() + "/reused";
+    {
+        wall_clock _obj{};
+        for(int i = 0; i < 3; ++i)
+        {
+            tim::operation::push_node<wall_clock>(_obj, tim::scope::get_default(),
+                                                  tim::add_hash_id(_reused));
+            tim::operation::start<wall_clock>{ _obj };
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+            tim::operation::stop<wall_clock>{ _obj };
+            tim::operation::pop_node<wall_clock>{ _obj };
+        }
+    }
+    // the components of a bundle are pushed and popped in the same order
+    auto _nested = details::get_test_name() + "/nested";
+    {
+        using pair_bundle_t = tim::component_tuple<wall_clock, cpu_clock>;
+        pair_bundle_t _outer{ _nested + "/outer" };
+        pair_bundle_t _inner{ _nested + "/inner" };
+        _outer.start();
+        _inner.start();
+        _inner.stop();
+        _outer.stop();
+    }
+    event_trace::enabled() = false;
+
+    // nothing was inserted into the call-graph
+    EXPECT_EQ(storage_t::instance()->size(), _size);
+
+    event_trace::finalize();
+    auto _fname = event_trace::get_writer().get_filename();
+    EXPECT_EQ(event_trace::get_writer().get_count(), 2 * 2 * 2 * _labels.size() + 14);
+
+    std::ifstream _ifs{ _fname, std::ios::binary };
+    ASSERT_TRUE(_ifs) << _fname;
+
+    event_trace::file_header _header{};
+    _ifs.read(reinterpret_cast<char*>(&_header), sizeof(_header));
+    EXPECT_EQ(std::string(_header.magic, 8), std::string("TIMTRACE"));
+    EXPECT_EQ(_header.version, 1);
+    EXPECT_EQ(_header.endian, 0x01020304);
+    EXPECT_EQ(_header.record_size, sizeof(event_trace::record));
+    ASSERT_GT(_header.tables, sizeof(_header));
+
+    auto _nrecords = (_header.tables - sizeof(_header)) / sizeof(event_trace::record);
+    EXPECT_EQ(_nrecords, event_trace::get_writer().get_count());
+
+    // the events of each thread are in time order and every begin has an end
+    std::map<uint32_t, std::vector<event_trace::record>> _records{};
+    for(size_t i = 0; i < _nrecords; ++i)
+    {
+        event_trace::record _v{};
+        _ifs.read(reinterpret_cast<char*>(&_v), sizeof(_v));
+        _records[_v.tid].emplace_back(_v);
+    }
+    EXPECT_EQ(_records.size(), 2);
+    // the value and the elapsed time between the begin and end records in seconds
+    auto                                   _reused_hash  = tim::get_hash_id(_reused);
+    int64_t                                _reused_begin = 0;
+    std::vector<std::pair<double, double>> _intervals{};
+    for(auto& itr : _records)
+    {
+        std::vector<uint64_t> _stack{};
+        int64_t               _last = 0;
+        for(auto& ritr : itr.second)
+        {
+            EXPECT_GE(ritr.timestamp, _last);
+            _last = ritr.timestamp;
+            if(ritr.phase == static_cast<uint8_t>(event_trace::phase::begin))
+            {
+                _stack.emplace_back(ritr.hash);
+                if(ritr.hash == _reused_hash)
+                    _reused_begin = ritr.timestamp;
+                continue;
+            }
+            ASSERT_FALSE(_stack.empty());
+            EXPECT_EQ(_stack.back(), ritr.hash);
+            EXPECT_GE(ritr.value, 0.0);
+            _stack.pop_back();
+            if(ritr.hash == _reused_hash)
+                _intervals.emplace_back(ritr.value / wall_clock::get_unit(),
+                                        1.0e-9 * (ritr.timestamp - _reused_begin));
+        }
+        EXPECT_TRUE(_stack.empty());
+    }
+
+    // the accumulated value would exceed the elapsed time of the second and third
+    ASSERT_EQ(_intervals.size(), 3);
+    for(const auto& itr : _intervals)
+    {
+        EXPECT_GT(itr.first, 0.0);
+        EXPECT_LE(itr.first, itr.second);
+    }
+
+    // the tables resolve the component and the labels
+    event_trace::reader _reader{ _fname };
+    ASSERT_TRUE(_reader.is_valid()) << _reader.get_error();
+    EXPECT_EQ(_reader.get_count(), _nrecords);
+    ASSERT_EQ(_reader.get_types().size(), 2);
+    EXPECT_EQ(_reader.get_types().at(0).label, wall_clock::get_label());
+    EXPECT_EQ(_reader.get_types().at(1).label, cpu_clock::get_label());
+    for(const auto& itr : _labels)
+        EXPECT_EQ(_reader.get_label(tim::get_hash_id(itr)), itr);
+
+    // the trace event format has a begin and end event for every record and the end
+    // event closes the last begin event of the same component on its track
+    auto _json = event_trace::write_chrome_trace(_fname);
+    ASSERT_FALSE(_json.empty());
+    auto _field = [](const std::string& _line, const std::string& _key) {
+        auto _pos = _line.find("\"" + _key + "\":");
+        if(_pos == std::string::npos)
+            return std::string{};
+        _pos += _key.length() + 3;
+        if(_line.at(_pos) == '"')
+            return _line.substr(_pos + 1, _line.find('"', _pos + 1) - _pos - 1);
+        return _line.substr(_pos, _line.find_first_of(",}", _pos) - _pos);
+    };
+    using slice_t = std::pair<std::string, std::string>;
+    std::ifstream                                _jfs{ _json };
+    std::string                                  _line{};
+    std::map<std::string, size_t>                _phases{};
+    std::map<std::string, std::vector<slice_t>>  _tracks{};
+    std::map<std::string, std::set<std::string>> _categories{};
+    while(std::getline(_jfs, _line))
+    {
+        auto _ph = _field(_line, "ph");
+        if(_ph.empty())
+            continue;
+        ++_phases[_ph];
+        if(_ph != "B" && _ph != "E")
+            continue;
+        auto  _tid   = _field(_line, "tid");
+        auto  _slice = slice_t{ _field(_line, "name"), _field(_line, "cat") };
+        auto& _stack = _tracks[_tid];
+        _categories[_tid].insert(_slice.second);
+        if(_ph == "B")
+        {
+            _stack.emplace_back(_slice);
+            continue;
+        }
+        ASSERT_FALSE(_stack.empty()) << _line;
+        EXPECT_EQ(_stack.back(), _slice) << _line;
+        _stack.pop_back();
+    }
+    EXPECT_EQ(_phases["B"], _nrecords / 2);
+    EXPECT_EQ(_phases["E"], _nrecords / 2);
+    EXPECT_EQ(_phases["C"], 0);
+    // the process and the wall-clock of both threads and the cpu-clock of this thread
+    EXPECT_EQ(_phases["M"], 4);
+    EXPECT_EQ(_tracks.size(), 3);
+    for(const auto& itr : _tracks)
+        EXPECT_TRUE(itr.second.empty()) << "tid: " << itr.first;
+    for(const auto& itr : _categories)
+        EXPECT_EQ(itr.second.size(), 1) << "tid: " << itr.first;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, node_index_benchmark)
+{
+    auto _wide = details::get_wide_keys();
+    auto _deep = details::get_deep_keys();
+
+    auto _wide_map = details::benchmark<nested_map_t>("wide (unordered_map)", _wide);
+    auto _wide_idx = details::benchmark<node_index_t>("wide (node_index)", _wide);
+    auto _deep_map = details::benchmark<nested_map_t>("deep (unordered_map)", _deep);
+    auto _deep_idx = details::benchmark<node_index_t>("deep (node_index)", _deep);
+
+    std::cout << "\nnode_index speed-up (wide): " << std::setprecision(3)
+              << (_wide_map / _wide_idx) << "x"
+              << "\nnode_index speed-up (deep): " << std::setprecision(3)
+              << (_deep_map / _deep_idx) << "x\n"
+              << std::endl;
+
+    EXPECT_GT(_wide_idx, 0.0);
+    EXPECT_GT(_deep_idx, 0.0);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, insert_benchmark)
+{
+    auto _wide = details::get_labels(details::get_test_name() + "/wide", nwidth / 4);
+    auto _deep = details::get_labels(details::get_test_name() + "/deep", ndepth);
+
+    auto _wide_latency = details::benchmark_storage("wide (storage)", details::wide, _wide);
+    auto _deep_latency = details::benchmark_storage("deep (storage)", details::deep, _deep);
+
+    EXPECT_GT(_wide_latency, 0.0);
+    EXPECT_GT(_deep_latency, 0.0);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, parallel_merge)
+{
+    auto    _label    = details::get_test_name();
+    auto    _bsize    = storage_t::instance()->size();
+    int64_t _nworkers = 8;
+
+    details::benchmark_merge(_label, _nworkers, 4);
+
+    // the worker call-graphs are combined before they reach the master so there is
+    // one node per unique call-path: 64 outer labels, each with 4 inner labels
+    EXPECT_EQ(storage_t::instance()->size() - _bsize, static_cast<size_t>(64 * 5))
+        << _label;
+
+    auto _data   = storage_t::instance()->get();
+    auto _nfound = 0;
+    for(auto& itr : _data)
+    {
+        if(itr.prefix().find(_label + "/") == std::string::npos)
+            continue;
+        ++_nfound;
+        EXPECT_EQ(itr.data().get_laps(), _nworkers) << itr.prefix();
+    }
+    EXPECT_EQ(_nfound, 64 * 5);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(storage_tests, parallel_merge_benchmark)
+{
+    for(int64_t _nworkers : { 4, 16, 64 })
+    {
+        auto _label = details::get_test_name() + "/" + std::to_string(_nworkers);
+        auto _serial   = details::benchmark_merge(_label + "/serial", _nworkers, 0);
+        auto _parallel = details::benchmark_merge(
+            _label + "/parallel", _nworkers, std::thread::hardware_concurrency());
+        EXPECT_GT(_serial, 0.0);
+        EXPECT_GT(_parallel, 0.0);
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+#if defined(_UNIX)
+TEST_F(storage_tests, parallel_output)
+{
+    // with more than one component the messages of the components would be
+    // interleaved when they are not written in order
+    using cpu_bundle_t = tim::component_tuple<wall_clock, cpu_clock>;
+
+    auto _label = details::get_test_name();
+    for(int64_t i = 0; i < 4; ++i)
+    {
+        details::wide({ _label, _label + "/a", _label + "/b" });
+        details::deep({ _label, _label + "/a", _label + "/b" });
+        cpu_bundle_t _obj{ _label + "/cpu" };
+        _obj.start();
+        details::wide({ _label + "/c" });
+        _obj.stop();
+    }
+
+    // the console output contains the names of the files so both are written to the
+    // same directory
+    auto _dir    = std::string{ "parallel-output-tests" };
+    auto _serial = _dir + "-serial";
+    details::remove_dir(_dir);
+    details::remove_dir(_serial);
+
+    details::finalize_copy(0, _dir, _serial + ".txt");
+    ASSERT_EQ(rename(_dir.c_str(), _serial.c_str()), 0);
+    details::finalize_copy(4, _dir, _dir + ".txt");
+
+    // the output of the components, the console output and the order of the
+    // messages are identical
+    auto _files = details::list_files(_serial);
+    EXPECT_GT(_files.size(), 0);
+    EXPECT_EQ(details::list_files(_dir), _files);
+    for(const auto& itr : _files)
+    {
+        EXPECT_EQ(details::read_file(_dir + "/" + itr),
+                  details::read_file(_serial + "/" + itr))
+            << itr;
+    }
+
+    auto _cout = details::read_file(_serial + ".txt");
+    EXPECT_NE(_cout.find(_dir + "/wall.flamegraph.json"), std::string::npos);
+    EXPECT_NE(_cout.find(_dir + "/cpu.flamegraph.json"), std::string::npos);
+    EXPECT_EQ(details::read_file(_dir + ".txt"), _cout);
+
+    details::remove_dir(_dir);
+    details::remove_dir(_serial);
+    remove((_dir + ".txt").c_str());
+    remove((_serial + ".txt").c_str());
+}
+#endif
+
+//--------------------------------------------------------------------------------------//
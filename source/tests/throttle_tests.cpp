@@ -27,6 +27,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <iostream>
+#include <limits>
 #include <mutex>
 #include <random>
 #include <thread>
@@ -34,6 +35,7 @@
 
 #include "timemory/library.h"
 #include "timemory/timemory.hpp"
+#include "timemory/trace.hpp"
 
 static int    _argc = 0;
 static char** _argv = nullptr;
@@ -288,6 +290,91 @@ TEST_F(throttle_tests, tuple_multithreaded)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(throttle_tests, trace_rate)
+{
+    using clock_type = std::chrono::steady_clock;
+    using duration_t = std::chrono::duration<double>;
+
+    // nested functions which are never throttled
+    auto _count                     = tim::settings::throttle_count();
+    tim::settings::throttle_count() = std::numeric_limits<size_t>::max();
+
+    auto                  name = details::get_test_name();
+    std::vector<uint64_t> ids{};
+    for(int i = 0; i < 8; ++i)
+        ids.emplace_back(tim::add_hash_id(TIMEMORY_JOIN("/", name, i)));
+
+    const size_t nitr = 20000;
+    auto         _run = [&ids](size_t _n) {
+        for(size_t i = 0; i < _n; ++i)
+        {
+            for(auto itr = ids.begin(); itr != ids.end(); ++itr)
+                timemory_push_trace_hash(*itr);
+            for(auto itr = ids.rbegin(); itr != ids.rend(); ++itr)
+                timemory_pop_trace_hash(*itr);
+        }
+    };
+
+    _run(nitr / 100);
+    auto _beg = clock_type::now();
+    _run(nitr);
+    duration_t _elapsed = clock_type::now() - _beg;
+
+    tim::settings::throttle_count() = _count;
+
+    auto _rate = (nitr * ids.size()) / _elapsed.count();
+    printf("\n[%s]> %.3e push/pop pairs per second (%.1f ns each)\n\n", name.c_str(),
+           _rate, 1.0e9 / _rate);
+
+    EXPECT_GT(_rate, 0.0);
+    for(int i = 0; i < 8; ++i)
+        EXPECT_FALSE(timemory_is_throttled(TIMEMORY_JOIN("/", name, i).c_str()));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(throttle_tests, adaptive_period)
+{
+    tim::trace::throttle::config _cfg{};
+    _cfg.value      = 1000;
+    _cfg.budget     = 0.02;
+    _cfg.max_period = 8;
+
+    tim::trace::throttle _throttle{};
+    EXPECT_FALSE(_throttle.is_throttled());
+
+    // cheap function: the period doubles up to the maximum
+    for(uint32_t i = 0; i < 5; ++i)
+        _throttle.update(_cfg, 10, 0.0);
+    EXPECT_TRUE(_throttle.is_throttled());
+    EXPECT_EQ(_throttle.period, 8);
+
+    size_t _measured = 0;
+    for(size_t i = 0; i < 64; ++i)
+        _measured += (_throttle.sample()) ? 1 : 0;
+    EXPECT_EQ(_measured, 8);
+
+    // the cost of the function rose: every call is measured again
+    EXPECT_EQ(_throttle.update(_cfg, 10 * _cfg.value, 0.0), 8);
+    EXPECT_FALSE(_throttle.is_throttled());
+    EXPECT_TRUE(_throttle.sample());
+    EXPECT_TRUE(_throttle.sample());
+
+    // expensive function but the instrumentation is over the budget
+    _throttle.update(_cfg, 10 * _cfg.value, 2 * _cfg.budget);
+    EXPECT_EQ(_throttle.period, 2);
+
+    // within the budget but not well within it: the period is kept
+    _throttle.update(_cfg, 10 * _cfg.value, 0.75 * _cfg.budget);
+    EXPECT_EQ(_throttle.period, 2);
+
+    _throttle.disable();
+    EXPECT_EQ(_throttle.update(_cfg, 10 * _cfg.value, 0.0), 0);
+    EXPECT_FALSE(_throttle.sample());
+}
+
+//--------------------------------------------------------------------------------------//
+
 int
 main(int argc, char** argv)
 {
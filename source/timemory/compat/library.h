@@ -123,6 +123,17 @@ extern "C"
     /// Turn on timemory collection
     extern void timemory_resume(void) TIMEMORY_VISIBLE;
 
+    /// \fn uint64_t timemory_get_memory_usage(void)
+    /// Returns the number of heap bytes held by the storage of every component on every
+    /// thread. The breakdown by component, thread and data structure is available from
+    /// \ref tim::manager::get_storage<Types...>::usage
+    extern uint64_t timemory_get_memory_usage(void) TIMEMORY_VISIBLE;
+
+    /// \fn uint64_t timemory_get_component_memory_usage(int component)
+    /// Returns the number of heap bytes held by the storage of the component on every
+    /// thread, including the hash maps shared with the other components
+    extern uint64_t timemory_get_component_memory_usage(int component) TIMEMORY_VISIBLE;
+
     /// \fn void timemory_set_default(const char* components)
     /// Pass in a default set of components to use. Will be overridden by
     /// TIMEMORY_COMPONENTS environment variable.
@@ -232,6 +243,32 @@ extern "C"
     ///
     extern void timemory_end_record(uint64_t id) TIMEMORY_VISIBLE;
 
+    /// \fn void timemory_begin_records(int n, const char** names, uint64_t* ids)
+    /// \param [in] n number of records
+    /// \param [in] names labels for the records
+    /// \param [out] ids identifiers passed back to \ref timemory_end_records
+    ///
+    /// Equivalent to calling \ref timemory_begin_record for each label in order, i.e.
+    /// the records are nested, but the library state and the current components are
+    /// checked once for all of the records.
+    ///
+    /// \code{.cpp}
+    /// const char* names[] = { "outer", "middle", "inner" };
+    /// uint64_t    ids[3];
+    /// timemory_begin_records(3, names, ids);
+    /// // ...
+    /// timemory_end_records(3, ids);
+    /// \endcode
+    extern void timemory_begin_records(int n, const char** names,
+                                       uint64_t* ids) TIMEMORY_VISIBLE;
+
+    /// \fn void timemory_end_records(int n, const uint64_t* ids)
+    /// \param [in] n number of records
+    /// \param [in] ids identifiers assigned by \ref timemory_begin_records
+    ///
+    /// Ends the records in the reverse order of the array.
+    extern void timemory_end_records(int n, const uint64_t* ids) TIMEMORY_VISIBLE;
+
     /// \fn void timemory_push_region(const char* name)
     /// \param [in] name label for region
     ///
@@ -262,6 +299,46 @@ extern "C"
     /// \endcode
     extern void timemory_pop_region(const char* name) TIMEMORY_VISIBLE;
 
+    /// \fn uint64_t timemory_register_region(const char* name)
+    /// \param [in] name label for region
+    ///
+    /// Registers the label with the current set of components and returns a handle
+    /// for \ref timemory_push_region_handle and \ref timemory_pop_region_handle.
+    /// Registering the same label and components again returns the same handle. The
+    /// handles are valid on every thread.
+    ///
+    /// \code{.cpp}
+    /// static uint64_t idx = timemory_register_region("foo");
+    /// for(int i = 0; i < n; ++i)
+    /// {
+    ///     timemory_push_region_handle(idx);
+    ///     // ...
+    ///     timemory_pop_region_handle(idx);
+    /// }
+    /// \endcode
+    extern uint64_t timemory_register_region(const char* name) TIMEMORY_VISIBLE;
+
+    /// \fn uint64_t timemory_register_region_types(const char* name, const char* types)
+    /// Similar to \ref timemory_register_region but accepts a specific set of
+    /// components as a string.
+    extern uint64_t timemory_register_region_types(const char* name,
+                                                   const char* ctypes) TIMEMORY_VISIBLE;
+
+    /// \fn void timemory_push_region_handle(uint64_t handle)
+    /// \param [in] handle value returned by \ref timemory_register_region
+    ///
+    /// Starts collection of the components of the registered region. Unlike \ref
+    /// timemory_push_region, the label is not hashed or looked up and the components
+    /// are reused by the following pushes of the handle on the thread.
+    extern void timemory_push_region_handle(uint64_t handle) TIMEMORY_VISIBLE;
+
+    /// \fn void timemory_pop_region_handle(uint64_t handle)
+    /// \param [in] handle value returned by \ref timemory_register_region
+    ///
+    /// Stops collection of the components started by the last \ref
+    /// timemory_push_region_handle of the handle on the thread.
+    extern void timemory_pop_region_handle(uint64_t handle) TIMEMORY_VISIBLE;
+
     extern void        c_timemory_init(int argc, char** argv,
                                        timemory_settings) TIMEMORY_VISIBLE;
     extern void        c_timemory_finalize(void) TIMEMORY_VISIBLE;
@@ -132,6 +132,9 @@ get_opaque(scope::config _scope)
             DEBUG_PRINT_HERE("Pushing %s", demangle<Toolset>().c_str());
             auto     _hash   = add_hash_id(_prefix);
             Toolset* _result = static_cast<Toolset*>(v_result);
+            // reset the data, as a bundle does when pushed, so a reused bundle does
+            // not add the previous measurement to the new node
+            invoke::reset<TIMEMORY_API>(std::tie(*_result));
             invoke::push<TIMEMORY_API>(std::tie(*_result), _scope + arg_scope, _hash);
         }
     };
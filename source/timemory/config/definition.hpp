@@ -40,6 +40,8 @@
 #    include "timemory/manager/declaration.hpp"
 #    include "timemory/mpl/filters.hpp"
 #    include "timemory/settings/declaration.hpp"
+#    include "timemory/storage/chrome_trace.hpp"
+#    include "timemory/storage/event_trace.hpp"
 #    include "timemory/utility/signals.hpp"
 #    include "timemory/utility/utility.hpp"
 
@@ -156,6 +158,7 @@ timemory_init(int argc, char** argv, const std::string& _prefix,
         }
 
         settings::store_command_line(argc, argv);
+        event_trace::configure();
     }
 
     static auto _manager = manager::instance();
@@ -418,6 +421,11 @@ timemory_finalize()
     if(_manager)
         _manager->finalize();
 
+    // write the remaining events and close the event trace
+    event_trace::finalize();
+    if(settings::chrome_trace_output())
+        event_trace::write_chrome_trace(event_trace::get_writer().get_filename());
+
     if(_settings)
     {
         if(_settings->get_upcxx_finalize())
@@ -0,0 +1,191 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * \file timemory/hash/algorithm.hpp
+ * \brief 64-bit string hash functions which can be evaluated at compile-time
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tim
+{
+namespace hash
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::hash::fnv1a
+/// \brief 64-bit FNV-1a. Processes one byte per multiplication.
+///
+struct fnv1a
+{
+    static constexpr uint64_t offset = 14695981039346656037ULL;
+    static constexpr uint64_t prime  = 1099511628211ULL;
+
+    static constexpr uint64_t compute(const char* _str, size_t _n, uint64_t _seed = 0)
+    {
+        uint64_t _val = offset ^ _seed;
+        for(size_t i = 0; i < _n; ++i)
+            _val = (_val ^ static_cast<unsigned char>(_str[i])) * prime;
+        return _val;
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::hash::wyhash
+/// \brief The final version 4 of wyhash by Wang Yi (public domain). Processes 16 or
+/// 48 bytes per iteration with 64x64 -> 128-bit multiplications. The bytes are assembled
+/// in little-endian order without memcpy so the function is usable in constant
+/// expressions and produces the same value on every platform; compilers fold the byte
+/// reads into a single load.
+///
+struct wyhash
+{
+    static constexpr uint64_t secret0 = 0x2d358dccaa6c78a5ULL;
+    static constexpr uint64_t secret1 = 0x8bb84b93962eacc9ULL;
+    static constexpr uint64_t secret2 = 0x4b33a62ed433d4a3ULL;
+    static constexpr uint64_t secret3 = 0x4d5a2da51de1aa47ULL;
+
+    struct uint128
+    {
+        uint64_t lo;
+        uint64_t hi;
+    };
+
+    static constexpr uint128 mum(uint64_t _a, uint64_t _b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 uint128_t;
+        uint128_t _r = static_cast<uint128_t>(_a) * _b;
+        return { static_cast<uint64_t>(_r), static_cast<uint64_t>(_r >> 64) };
+#else
+        uint64_t _ha = _a >> 32, _hb = _b >> 32;
+        uint64_t _la = static_cast<uint32_t>(_a), _lb = static_cast<uint32_t>(_b);
+        uint64_t _rh = _ha * _hb, _rm0 = _ha * _lb, _rm1 = _hb * _la, _rl = _la * _lb;
+        uint64_t _t  = _rl + (_rm0 << 32);
+        uint64_t _c  = (_t < _rl) ? 1 : 0;
+        uint64_t _lo = _t + (_rm1 << 32);
+        _c += (_lo < _t) ? 1 : 0;
+        return { _lo, _rh + (_rm0 >> 32) + (_rm1 >> 32) + _c };
+#endif
+    }
+
+    static constexpr uint64_t mix(uint64_t _a, uint64_t _b)
+    {
+        auto _r = mum(_a, _b);
+        return _r.lo ^ _r.hi;
+    }
+
+    static constexpr uint64_t byte(const char* _p, size_t _i)
+    {
+        return static_cast<uint64_t>(static_cast<unsigned char>(_p[_i]));
+    }
+
+    static constexpr uint64_t read4(const char* _p)
+    {
+        return byte(_p, 0) | (byte(_p, 1) << 8) | (byte(_p, 2) << 16) |
+               (byte(_p, 3) << 24);
+    }
+
+    static constexpr uint64_t read8(const char* _p)
+    {
+        return read4(_p) | (read4(_p + 4) << 32);
+    }
+
+    static constexpr uint64_t read3(const char* _p, size_t _n)
+    {
+        return (byte(_p, 0) << 16) | (byte(_p, _n >> 1) << 8) | byte(_p, _n - 1);
+    }
+
+    static constexpr uint64_t compute(const char* _p, size_t _n, uint64_t _seed = 0)
+    {
+        _seed ^= mix(_seed ^ secret0, secret1);
+        uint64_t _a = 0;
+        uint64_t _b = 0;
+        if(_n <= 16)
+        {
+            if(_n >= 4)
+            {
+                size_t _off = (_n >> 3) << 2;
+                _a          = (read4(_p) << 32) | read4(_p + _off);
+                _b          = (read4(_p + _n - 4) << 32) | read4(_p + _n - 4 - _off);
+            }
+            else if(_n > 0)
+            {
+                _a = read3(_p, _n);
+            }
+        }
+        else
+        {
+            size_t      _i = _n;
+            const char* _q = _p;
+            if(_i > 48)
+            {
+                uint64_t _see1 = _seed;
+                uint64_t _see2 = _seed;
+                do
+                {
+                    _seed = mix(read8(_q) ^ secret1, read8(_q + 8) ^ _seed);
+                    _see1 = mix(read8(_q + 16) ^ secret2, read8(_q + 24) ^ _see1);
+                    _see2 = mix(read8(_q + 32) ^ secret3, read8(_q + 40) ^ _see2);
+                    _q += 48;
+                    _i -= 48;
+                } while(_i > 48);
+                _seed ^= _see1 ^ _see2;
+            }
+            while(_i > 16)
+            {
+                _seed = mix(read8(_q) ^ secret1, read8(_q + 8) ^ _seed);
+                _i -= 16;
+                _q += 16;
+            }
+            _a = read8(_q + _i - 16);
+            _b = read8(_q + _i - 8);
+        }
+        auto _r = mum(_a ^ secret1, _b ^ _seed);
+        return mix(_r.lo ^ secret0 ^ _n, _r.hi ^ secret1);
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the number of characters before the terminating null character
+constexpr size_t
+length(const char* _str)
+{
+    size_t _n = 0;
+    while(_str && _str[_n] != '\0')
+        ++_n;
+    return _n;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace hash
+}  // namespace tim
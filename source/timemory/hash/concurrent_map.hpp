@@ -0,0 +1,206 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * \file timemory/hash/concurrent_map.hpp
+ * \brief Insert-only hash map keyed by a hash value which is shared by all threads
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::concurrent_hash_map
+/// \brief Insert-only map from an integral hash to a value which is shared by all
+/// threads. Lookups are lock-free: they probe an open-addressing table of pointers to
+/// the entries. Insertions are serialized by a mutex and are expected to be rare
+/// (once per unique key). The entries are never moved or erased so the pointer returned
+/// by \ref find (and any reference or string_view into the value) remains valid for the
+/// lifetime of the map. When the table grows, the previous table is retained so
+/// concurrent readers of it are never invalidated. The returned iterators are pointers
+/// to the entries and \ref end is a null pointer so the common
+/// `itr = find(key); if(itr != end()) itr->second` idiom is supported but the map is
+/// traversed with \ref for_each instead of iterators.
+///
+template <typename KeyT, typename MappedT>
+class concurrent_hash_map
+{
+public:
+    using key_type       = KeyT;
+    using mapped_type    = MappedT;
+    using value_type     = std::pair<const KeyT, MappedT>;
+    using size_type      = size_t;
+    using const_iterator = const value_type*;
+    using iterator       = const_iterator;
+
+    static constexpr size_type min_capacity = 64;
+
+public:
+    concurrent_hash_map() { m_table.store(add_table(min_capacity)); }
+    ~concurrent_hash_map() = default;
+
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map(concurrent_hash_map&&)      = delete;
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(concurrent_hash_map&&) = delete;
+
+    /// lock-free lookup, returns \ref end if the key does not exist
+    const_iterator find(key_type _key) const
+    {
+        const table_type* _tbl = m_table.load(std::memory_order_acquire);
+        for(size_type i = get_index(_key, _tbl->mask);; i = (i + 1) & _tbl->mask)
+        {
+            const value_type* _v = _tbl->slots[i].load(std::memory_order_acquire);
+            if(!_v || _v->first == _key)
+                return _v;
+        }
+    }
+
+    const_iterator end() const { return nullptr; }
+    size_type      count(key_type _key) const { return (find(_key)) ? 1 : 0; }
+    size_type      size() const { return m_size.load(std::memory_order_acquire); }
+    bool           empty() const { return size() == 0; }
+
+    /// construct the value in-place if the key does not exist. The second member of
+    /// the return value is false if the key already existed
+    template <typename... Args>
+    std::pair<const_iterator, bool> emplace(key_type _key, Args&&... _args)
+    {
+        std::lock_guard<std::mutex> _lk{ m_mutex };
+        if(auto _v = find(_key))
+            return { _v, false };
+
+        m_entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(_key),
+                               std::forward_as_tuple(std::forward<Args>(_args)...));
+        const value_type* _v = &m_entries.back();
+
+        // keep the load factor at or below 0.5 so the probe sequences stay short
+        table_type* _tbl = m_tables.back().get();
+        if(2 * m_entries.size() > _tbl->slots.size())
+        {
+            _tbl = add_table(2 * _tbl->slots.size());
+            for(size_type i = 0; i + 1 < m_entries.size(); ++i)
+                publish(*_tbl, &m_entries[i]);
+            publish(*_tbl, _v);
+            m_table.store(_tbl, std::memory_order_release);
+        }
+        else
+        {
+            publish(*_tbl, _v);
+        }
+        m_size.store(m_entries.size(), std::memory_order_release);
+        return { _v, true };
+    }
+
+    std::pair<const_iterator, bool> insert(const value_type& _v)
+    {
+        return emplace(_v.first, _v.second);
+    }
+
+    /// invoke the function with each entry in the order of insertion
+    template <typename FuncT>
+    void for_each(FuncT&& _func) const
+    {
+        std::lock_guard<std::mutex> _lk{ m_mutex };
+        for(const auto& itr : m_entries)
+            _func(itr);
+    }
+
+    /// bytes of the entries and the lookup tables, excluding any heap memory owned by
+    /// the mapped values
+    size_type bytes() const
+    {
+        std::lock_guard<std::mutex> _lk{ m_mutex };
+        size_type                   _n = m_entries.size() * sizeof(value_type);
+        for(const auto& itr : m_tables)
+            _n += sizeof(table_type) + itr->slots.size() * sizeof(slot_type);
+        return _n;
+    }
+
+private:
+    using slot_type = std::atomic<const value_type*>;
+
+    struct table_type
+    {
+        explicit table_type(size_type _n)
+        : mask{ _n - 1 }
+        , slots(_n)
+        {
+            for(auto& itr : slots)
+                itr.store(nullptr, std::memory_order_relaxed);
+        }
+
+        size_type              mask = 0;
+        std::vector<slot_type> slots;
+    };
+
+    static size_type get_index(key_type _key, size_type _mask)
+    {
+        auto _v = static_cast<uint64_t>(_key);
+        return static_cast<size_type>(_v ^ (_v >> 32)) & _mask;
+    }
+
+    // only called while holding the mutex so a slot has a single writer
+    static void publish(table_type& _tbl, const value_type* _v)
+    {
+        for(size_type i = get_index(_v->first, _tbl.mask);; i = (i + 1) & _tbl.mask)
+        {
+            if(!_tbl.slots[i].load(std::memory_order_relaxed))
+            {
+                _tbl.slots[i].store(_v, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    table_type* add_table(size_type _n)
+    {
+        m_tables.emplace_back(new table_type{ _n });
+        return m_tables.back().get();
+    }
+
+private:
+    mutable std::mutex                       m_mutex{};
+    std::atomic<size_type>                   m_size{ 0 };
+    std::atomic<table_type*>                 m_table{ nullptr };
+    std::deque<value_type>                   m_entries{};
+    std::vector<std::unique_ptr<table_type>> m_tables{};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace tim
@@ -47,8 +47,7 @@ namespace tim
 TIMEMORY_HASH_LINKAGE(graph_hash_map_ptr_t&)
 get_hash_ids()
 {
-    static thread_local auto _inst =
-        get_shared_ptr_pair_instance<graph_hash_map_t, TIMEMORY_API>();
+    static auto _inst = std::make_shared<graph_hash_map_t>();
     return _inst;
 }
 //
@@ -57,8 +56,7 @@ get_hash_ids()
 TIMEMORY_HASH_LINKAGE(graph_hash_alias_ptr_t&)
 get_hash_aliases()
 {
-    static thread_local auto _inst =
-        get_shared_ptr_pair_instance<graph_hash_alias_t, TIMEMORY_API>();
+    static auto _inst = std::make_shared<graph_hash_alias_t>();
     return _inst;
 }
 //
@@ -83,13 +81,27 @@ add_hash_id(const graph_hash_map_ptr_t&   _hash_map,
     if(_hash_alias->find(_alias_hash_id) == _hash_alias->end() &&
        _hash_map->find(_hash_id) != _hash_map->end())
     {
-        (*_hash_alias)[_alias_hash_id] = _hash_id;
+        _hash_alias->emplace(_alias_hash_id, _hash_id);
     }
 }
 //
 //--------------------------------------------------------------------------------------//
 //
 TIMEMORY_HASH_LINKAGE(void)
+report_hash_collision(hash_value_type _hash_id, const std::string& _existing,
+                      const string_view_t& _prefix)
+{
+    ++get_hash_collisions();
+    fprintf(stderr,
+            "[timemory]> Warning! hash collision: '%s' and '%s' both have the hash %llu. "
+            "The regions will be combined\n",
+            _existing.c_str(), std::string{ _prefix }.c_str(),
+            (unsigned long long) _hash_id);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+TIMEMORY_HASH_LINKAGE(void)
 add_hash_id(hash_value_type _hash_id, hash_value_type _alias_hash_id)
 {
     add_hash_id(get_hash_ids(), get_hash_aliases(), _hash_id, _alias_hash_id);
@@ -123,13 +135,15 @@ get_hash_identifier(const graph_hash_map_ptr_t&   _hash_map,
 #    if defined(DEBUG)
         ss << "\nHash map:\n";
         auto _w = 30;
-        for(const auto& itr : *_hash_map)
+        _hash_map->for_each([&](const auto& itr) {
             ss << "    " << std::setw(_w) << itr.first << " : " << (itr.second) << "\n";
+        });
         if(_hash_alias->size() > 0)
         {
             ss << "Alias hash map:\n";
-            for(const auto& itr : *_hash_alias)
+            _hash_alias->for_each([&](const auto& itr) {
                 ss << "    " << std::setw(_w) << itr.first << " : " << itr.second << "\n";
+            });
         }
 #    endif
         fprintf(stderr, "%s\n", ss.str().c_str());
@@ -41,3 +41,10 @@
 #else
 #    define TIMEMORY_HASH_LINKAGE(...) inline __VA_ARGS__
 #endif
+//
+#if !defined(TIMEMORY_STATIC_HASH_ID)
+/// hash of a string literal computed at compile-time whose label is registered once per
+/// process, e.g. `tim::auto_tuple<wall_clock> _obj{ TIMEMORY_STATIC_HASH_ID("label") };`
+#    define TIMEMORY_STATIC_HASH_ID(LABEL)                                               \
+        ::tim::add_static_hash_id<::tim::hash_type{}(LABEL)>(LABEL)
+#endif
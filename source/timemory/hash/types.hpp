@@ -25,10 +25,15 @@
 #pragma once
 
 #include "timemory/api.hpp"
+#include "timemory/hash/algorithm.hpp"
+#include "timemory/hash/concurrent_map.hpp"
 #include "timemory/hash/macros.hpp"
 #include "timemory/macros/attributes.hpp"
 #include "timemory/macros/language.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -69,11 +74,47 @@ get_shared_ptr_pair_master_instance();
 //
 //--------------------------------------------------------------------------------------//
 //
-using hash_type = std::hash<string_view_t>;
+/// \struct tim::hash_type
+/// \brief 64-bit hash of a string. It is usable in constant expressions so the hash
+/// of a string literal computed at compile-time (see TIMEMORY_STATIC_HASH_ID) is
+/// identical to the hash of the same string computed at runtime. The algorithm is
+/// wyhash unless TIMEMORY_USE_FNV1A_HASH is defined.
+///
+struct hash_type
+{
+#if defined(TIMEMORY_USE_FNV1A_HASH)
+    using algorithm_type = hash::fnv1a;
+#else
+    using algorithm_type = hash::wyhash;
+#endif
+
+    static constexpr size_t compute(const char* _str, size_t _n)
+    {
+        return static_cast<size_t>(algorithm_type::compute(_str, _n));
+    }
+
+    constexpr size_t operator()(const char* _str) const
+    {
+        return compute(_str, hash::length(_str));
+    }
+
+    size_t operator()(const std::string& _str) const
+    {
+        return compute(_str.data(), _str.length());
+    }
+
+#if TIMEMORY_STRING_VIEW > 0
+    constexpr size_t operator()(string_view_t _str) const
+    {
+        return compute(_str.data(), _str.length());
+    }
+#endif
+};
+//
 using hash_value_type =
     std::decay_t<decltype(hash_type{}(std::declval<string_view_t>()))>;
-using graph_hash_map_t          = std::unordered_map<hash_value_type, std::string>;
-using graph_hash_alias_t        = std::unordered_map<hash_value_type, hash_value_type>;
+using graph_hash_map_t          = concurrent_hash_map<hash_value_type, std::string>;
+using graph_hash_alias_t        = concurrent_hash_map<hash_value_type, hash_value_type>;
 using graph_hash_map_ptr_t      = std::shared_ptr<graph_hash_map_t>;
 using graph_hash_map_ptr_pair_t = std::pair<graph_hash_map_ptr_t, graph_hash_map_ptr_t>;
 using graph_hash_alias_ptr_t    = std::shared_ptr<graph_hash_alias_t>;
@@ -84,11 +125,18 @@ using graph_hash_alias_ptr_t    = std::shared_ptr<graph_hash_alias_t>;
 //
 //--------------------------------------------------------------------------------------//
 //
+/// \fn graph_hash_map_ptr_t& get_hash_ids()
+/// \brief the process-wide table of hash to label. The labels are never moved or
+/// erased so references to them remain valid for the lifetime of the table
+///
 graph_hash_map_ptr_t&
 get_hash_ids() TIMEMORY_HOT;
 //
 //--------------------------------------------------------------------------------------//
 //
+/// \fn graph_hash_alias_ptr_t& get_hash_aliases()
+/// \brief the process-wide table of alias hash to hash
+///
 graph_hash_alias_ptr_t&
 get_hash_aliases() TIMEMORY_HOT;
 //
@@ -106,7 +154,7 @@ template <typename Tp>
 hash_value_type
 get_hash_id(Tp&& _prefix)
 {
-    return std::hash<string_view_t>{}(std::forward<Tp>(_prefix));
+    return hash_type{}(std::forward<Tp>(_prefix));
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -117,6 +165,38 @@ get_hash_id(const graph_hash_alias_ptr_t& _hash_alias,
 //
 //--------------------------------------------------------------------------------------//
 //
+/// \fn std::atomic<bool>& get_hash_collision_check()
+/// \brief when enabled, \ref add_hash_id compares the label with the existing label
+/// when the hash already exists and reports a collision if they differ. Enabled by
+/// default when DEBUG or TIMEMORY_HASH_COLLISION_CHECK is defined.
+///
+inline std::atomic<bool>&
+get_hash_collision_check()
+{
+#if defined(DEBUG) || defined(TIMEMORY_HASH_COLLISION_CHECK)
+    static std::atomic<bool> _instance{ true };
+#else
+    static std::atomic<bool> _instance{ false };
+#endif
+    return _instance;
+}
+//
+/// \fn std::atomic<uint64_t>& get_hash_collisions()
+/// \brief the number of collisions detected by \ref add_hash_id
+///
+inline std::atomic<uint64_t>&
+get_hash_collisions()
+{
+    static std::atomic<uint64_t> _instance{ 0 };
+    return _instance;
+}
+//
+void
+report_hash_collision(hash_value_type _hash_id, const std::string& _existing,
+                      const string_view_t& _prefix);
+//
+//--------------------------------------------------------------------------------------//
+//
 /// \fn hash_value_type add_hash_id(graph_hash_map_ptr_t&, const string_view_t&)
 /// \brief add an string to the given hash-map (if it doesn't already exist) and return
 /// the hash
@@ -128,10 +208,19 @@ inline hash_value_type
 add_hash_id(graph_hash_map_ptr_t& _hash_map, const string_view_t& _prefix)
 {
     hash_value_type _hash_id = get_hash_id(_prefix);
-    if(_hash_map && _hash_map->find(_hash_id) == _hash_map->end())
+    if(!_hash_map)
+        return _hash_id;
+    auto _itr = _hash_map->find(_hash_id);
+    if(_itr == _hash_map->end())
     {
-        (*_hash_map)[_hash_id] = std::string{ _prefix };
+        auto _ret = _hash_map->emplace(_hash_id, std::string{ _prefix });
+        if(_ret.second)
+            return _hash_id;
+        _itr = _ret.first;
     }
+    if(get_hash_collision_check().load(std::memory_order_relaxed) &&
+       _itr->second != _prefix)
+        report_hash_collision(_hash_id, _itr->second, _prefix);
     return _hash_id;
 }
 //
@@ -152,6 +241,22 @@ add_hash_id(const string_view_t& _prefix)
 //
 //--------------------------------------------------------------------------------------//
 //
+/// \fn hash_value_type add_static_hash_id<HashV>(const char*)
+/// \brief add the label of a hash computed at compile-time to the hash-map the first
+/// time it is called in the process and return the hash. The hash-map is shared by all
+/// the threads so subsequent calls only check the initialization of a static
+///
+template <hash_value_type HashV>
+hash_value_type
+add_static_hash_id(const char* _label)
+{
+    static bool _once = (add_hash_id(_label), true);
+    (void) _once;
+    return HashV;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
 void
 add_hash_id(const graph_hash_map_ptr_t&   _hash_map,
             const graph_hash_alias_ptr_t& _hash_alias, hash_value_type _hash_id,
@@ -169,8 +274,8 @@ add_hash_id(hash_value_type _hash_id, hash_value_type _alias_hash_id) TIMEMORY_H
 //--------------------------------------------------------------------------------------//
 //
 /// \fn string_view_t get_hash_identifier_fast(hash_value_type)
-/// \brief this does not check other threads or aliases. Only call this function when
-/// you know that the hash exists on the thread and is not an alias
+/// \brief this does not check the aliases. Only call this function when you know that
+/// the hash exists and is not an alias
 //
 string_view_t
 get_hash_identifier_fast(hash_value_type _hash) TIMEMORY_HOT;
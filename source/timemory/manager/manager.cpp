@@ -57,10 +57,13 @@
 
 #    include <algorithm>
 #    include <atomic>
+#    include <exception>
 #    include <fstream>
-#    include <iosfwd>
+#    include <iostream>
 #    include <memory>
+#    include <sstream>
 #    include <string>
+#    include <thread>
 #    include <utility>
 #    include <vector>
 
@@ -261,6 +264,8 @@ manager::finalize()
     //
     // finalize workers first
     _finalize(m_worker_finalizers);
+    // write the output of the masters before they are destroyed
+    write_output();
     // finalize masters second
     _finalize(m_master_finalizers);
 
@@ -295,6 +300,73 @@ manager::finalize()
 //----------------------------------------------------------------------------------//
 //
 TIMEMORY_MANAGER_LINKAGE(void)
+manager::write_output()
+{
+    auto _nthreads = (m_settings) ? m_settings->get_parallel_output() : 0;
+    if(_nthreads < 2 || m_master_outputs.empty())
+    {
+        // the output is written serially by the finalizers
+        m_master_outputs.clear();
+        return;
+    }
+
+    // same order as the master finalizers
+    std::reverse(m_master_outputs.begin(), m_master_outputs.end());
+
+    // gathering the results may communicate with the other processes so it is
+    // always done in order on this thread
+    std::vector<output_task_t> _tasks{};
+    for(auto& itr : m_master_outputs)
+        _tasks.emplace_back(itr.second());
+    m_master_outputs.clear();
+
+    if(f_debug())
+        PRINT_HERE("writing the output of %i components on %i threads",
+                   (int) _tasks.size(), (int) _nthreads);
+
+    // the files of each component are written concurrently and the messages are
+    // buffered so that the console output does not depend on the scheduling
+    auto                           _n = _tasks.size();
+    std::vector<std::stringstream> _buffers(_n);
+    std::vector<std::string>       _errors(_n);
+    auto                           _write = [&](size_t _i) {
+        if(!_tasks.at(_i).first)
+            return;
+        try
+        {
+            _tasks.at(_i).first(_buffers.at(_i));
+        } catch(std::exception& e)
+        {
+            _errors.at(_i) = e.what();
+        }
+    };
+
+    std::atomic<size_t>      _idx{ 0 };
+    std::vector<std::thread> _threads{};
+    for(size_t i = 0; i < std::min<size_t>(_nthreads, _n); ++i)
+    {
+        _threads.emplace_back([&]() {
+            size_t _i = 0;
+            while((_i = _idx++) < _n)
+                _write(_i);
+        });
+    }
+    for(auto& itr : _threads)
+        itr.join();
+
+    for(size_t i = 0; i < _n; ++i)
+    {
+        std::cout << _buffers.at(i).str() << std::flush;
+        if(!_errors.at(i).empty())
+            fprintf(stderr, "Exception: %s\n", _errors.at(i).c_str());
+        if(_tasks.at(i).second)
+            _tasks.at(i).second();
+    }
+}
+//
+//----------------------------------------------------------------------------------//
+//
+TIMEMORY_MANAGER_LINKAGE(void)
 manager::exit_hook()
 {
     if(f_debug())
@@ -499,8 +571,7 @@ manager::write_metadata(const char* context)
     std::map<std::string, std::set<size_t>> _hashes;
     if(m_hash_ids && m_hash_aliases)
     {
-        for(const auto& itr : (*m_hash_aliases))
-        {
+        m_hash_aliases->for_each([&](const auto& itr) {
             auto hitr = m_hash_ids->find(itr.second);
             if(hitr != m_hash_ids->end())
             {
@@ -509,9 +580,10 @@ manager::write_metadata(const char* context)
                 _hashes[operation::decode<TIMEMORY_API>{}(hitr->second)].insert(
                     hitr->first);
             }
-        }
-        for(const auto& itr : (*m_hash_ids))
+        });
+        m_hash_ids->for_each([&](const auto& itr) {
             _hashes[operation::decode<TIMEMORY_API>{}(itr.second)].insert(itr.first);
+        });
     }
     if(_hashes.empty())
         return;
@@ -551,6 +623,8 @@ TIMEMORY_MANAGER_LINKAGE(void)
 manager::add_file_output(const string_t& _category, const string_t& _label,
                          const string_t& _file)
 {
+    // the output files may be written concurrently, see manager::write_output
+    std::lock_guard<std::mutex> _lk{ m_output_mutex };
     m_output_files[_category][_label].insert(_file);
 }
 //
@@ -562,7 +636,10 @@ manager::add_text_output(const string_t& _label, const string_t& _file)
     add_file_output("text", _label, _file);
     auto _settings = f_settings();
     if(_settings && _settings->get_ctest_notes())
+    {
+        std::lock_guard<std::mutex> _lk{ m_output_mutex };
         operation::finalize::ctest_notes<manager>::get_notes()->insert(_file);
+    }
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -612,6 +689,15 @@ manager::remove_finalizer(const std::string& _key)
     _remove_finalizer(m_worker_cleanup);
     _remove_finalizer(m_master_finalizers);
     _remove_finalizer(m_worker_finalizers);
+
+    for(auto itr = m_master_outputs.begin(); itr != m_master_outputs.end(); ++itr)
+    {
+        if(itr->first == _key)
+        {
+            m_master_outputs.erase(itr);
+            break;
+        }
+    }
 }
 //
 //----------------------------------------------------------------------------------//
@@ -39,12 +39,15 @@
 #include "timemory/mpl/available.hpp"
 #include "timemory/mpl/policy.hpp"
 #include "timemory/settings/declaration.hpp"
+#include "timemory/storage/usage.hpp"
 #include "timemory/tpls/cereal/cereal.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <deque>
 #include <functional>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -53,6 +56,7 @@
 #include <thread>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace tim
 {
@@ -79,6 +83,10 @@ public:
     using finalizer_pair_t = std::pair<std::string, finalizer_func_t>;
     using finalizer_list_t = std::deque<finalizer_pair_t>;
     using finalizer_void_t = std::multimap<void*, finalizer_func_t>;
+    using output_func_t    = std::function<void(std::ostream&)>;
+    using output_task_t    = std::pair<output_func_t, finalizer_func_t>;
+    using output_pair_t    = std::pair<std::string, std::function<output_task_t()>>;
+    using output_list_t    = std::deque<output_pair_t>;
     using settings_ptr_t   = std::shared_ptr<settings>;
     using filemap_t        = std::map<string_t, std::map<string_t, std::set<string_t>>>;
     using metadata_func_t  = std::vector<std::function<void(void*)>>;
@@ -105,6 +113,10 @@ public:
     void add_cleanup(const std::string&, Func&&);
     template <typename StackFunc, typename FinalFunc>
     void add_finalizer(const std::string&, StackFunc&&, FinalFunc&&, bool);
+    // master storage-types add functors which gather the results and return the
+    // functions which write the output (see settings::parallel_output)
+    template <typename Func>
+    void add_output(const std::string&, Func&&);
     void remove_cleanup(const std::string&);
     void remove_finalizer(const std::string&);
     void cleanup(const std::string&);
@@ -161,6 +173,9 @@ private:
     template <typename Tp>
     void do_size(enum_map_t<uint64_t>& _sz);  // size for individual components
 
+    template <typename Tp>
+    void do_usage(enum_map_t<std::vector<storage_usage>>&);  // bytes per thread
+
     //----------------------------------------------------------------------------------//
     // used to expand a tuple in settings
     //
@@ -173,6 +188,9 @@ private:
         static void        print(pointer_t _manager = {}, const enum_set_t& = {});
         static uint64_t    size(pointer_t _manager = {});
         static enum_map_t<uint64_t> size(pointer_t _manager, const enum_set_t&);
+        static storage_usage        usage(pointer_t _manager = {});
+        static enum_map_t<std::vector<storage_usage>> usage(pointer_t _manager,
+                                                            const enum_set_t&);
 
         static std::string serialize(const enum_set_t& _types)
         {
@@ -206,6 +224,7 @@ private:
         using base_type::print;
         using base_type::serialize;
         using base_type::size;
+        using base_type::usage;
     };
 
 public:
@@ -220,6 +239,7 @@ public:
         using base_type::print;
         using base_type::serialize;
         using base_type::size;
+        using base_type::usage;
     };
 
     //----------------------------------------------------------------------------------//
@@ -234,6 +254,7 @@ public:
         using base_type::print;
         using base_type::serialize;
         using base_type::size;
+        using base_type::usage;
     };
 
     //----------------------------------------------------------------------------------//
@@ -267,6 +288,9 @@ protected:
     // protected functions
     TIMEMORY_NODISCARD string_t get_prefix() const;
 
+private:
+    void write_output();
+
 private:
     /// notifies that it is finalizing
     bool            m_is_finalizing   = false;
@@ -279,6 +303,7 @@ private:
     std::thread::id m_thread_id       = threading::get_tid();
     string_t        m_metadata_prefix = "";
     mutex_t         m_mutex;
+    std::mutex      m_output_mutex;
     auto_lock_ptr_t m_lock = auto_lock_ptr_t{ nullptr };
     /// increment the shared_ptr count here to ensure these instances live
     /// for the entire lifetime of the manager instance
@@ -290,6 +315,7 @@ private:
     finalizer_list_t       m_master_finalizers  = {};
     finalizer_list_t       m_worker_finalizers  = {};
     finalizer_void_t       m_pointer_fini       = {};
+    output_list_t          m_master_outputs     = {};
     filemap_t              m_output_files       = {};
     settings_ptr_t         m_settings           = settings::shared_instance();
 
@@ -410,6 +436,24 @@ manager::add_finalizer(const std::string& _key, StackFunc&& _stack_func,
     }
 }
 //
+//----------------------------------------------------------------------------------//
+//
+template <typename Func>
+void
+manager::add_output(const std::string& _key, Func&& _func)
+{
+    // ensure there are no duplicates
+    for(auto itr = m_master_outputs.begin(); itr != m_master_outputs.end(); ++itr)
+    {
+        if(itr->first == _key)
+        {
+            m_master_outputs.erase(itr);
+            break;
+        }
+    }
+    m_master_outputs.emplace_back(_key, std::forward<Func>(_func));
+}
+//
 //--------------------------------------------------------------------------------------//
 //
 template <typename Tp>
@@ -567,6 +611,22 @@ manager::do_size(enum_map_t<uint64_t>& _sz)
 //
 //----------------------------------------------------------------------------------//
 //
+template <typename Tp>
+void
+manager::do_usage(enum_map_t<std::vector<storage_usage>>& _usage)
+{
+    using storage_type = typename Tp::storage_type;
+
+    auto itr = _usage.find(component::properties<Tp>{}());
+    if(itr == _usage.end())
+        return;
+
+    if(storage_type::noninit_master_instance())
+        itr->second = storage_type::usages();
+}
+//
+//----------------------------------------------------------------------------------//
+//
 template <typename... Types>
 void
 manager::filtered_get_storage<Types...>::initialize(pointer_t _manager)
@@ -668,6 +728,53 @@ manager::filtered_get_storage<Types...>::size(pointer_t         _manager,
     return _sz;
 }
 //
+//----------------------------------------------------------------------------------//
+//
+template <typename... Types>
+storage_usage
+manager::filtered_get_storage<Types...>::usage(pointer_t _manager)
+{
+    enum_set_t _types{};
+    TIMEMORY_FOLD_EXPRESSION(_types.insert(component::properties<Types>{}()));
+
+    // the hash maps are shared by all the components and threads so they are only
+    // counted once
+    storage_usage _ret{};
+    for(const auto& citr : usage(_manager, _types))
+    {
+        for(const auto& itr : citr.second)
+        {
+            _ret.graph += itr.graph;
+            _ret.node_ids += itr.node_ids;
+            _ret.stack += itr.stack;
+            _ret.samples += itr.samples;
+            _ret.hash_ids     = std::max<uint64_t>(_ret.hash_ids, itr.hash_ids);
+            _ret.hash_aliases = std::max<uint64_t>(_ret.hash_aliases, itr.hash_aliases);
+        }
+    }
+    return _ret;
+}
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename... Types>
+manager::enum_map_t<std::vector<storage_usage>>
+manager::filtered_get_storage<Types...>::usage(pointer_t         _manager,
+                                               const enum_set_t& _types)
+{
+    if(_manager.get() == nullptr)
+        _manager = manager::instance();
+
+    enum_map_t<std::vector<storage_usage>> _usage{};
+    if(_manager)
+    {
+        for(auto& itr : _types)
+            _usage.insert({ itr, {} });
+        TIMEMORY_FOLD_EXPRESSION(_manager->do_usage<Types>(_usage));
+    }
+    return _usage;
+}
+//
 //--------------------------------------------------------------------------------------//
 //
 }  // namespace tim
@@ -35,6 +35,7 @@
 #include "timemory/mpl/types.hpp"
 #include "timemory/operations/macros.hpp"
 #include "timemory/settings/declaration.hpp"
+#include "timemory/storage/binary_output.hpp"
 #include "timemory/storage/types.hpp"
 #include "timemory/variadic/types.hpp"
 
@@ -652,6 +653,7 @@ struct merge<Type, true>
     using storage_type             = impl::storage<Type, has_data>;
     using singleton_t              = typename storage_type::singleton_type;
     using graph_t                  = typename storage_type::graph_type;
+    using iterator                 = typename storage_type::iterator;
     using result_type              = typename storage_type::result_array_t;
 
     template <typename Tp>
@@ -661,6 +663,11 @@ struct merge<Type, true>
 
     merge(storage_type& lhs, storage_type& rhs);
     merge(result_type& lhs, result_type& rhs);
+    merge(graph_t& _graph, iterator _dst, iterator _src);
+    merge(graph_t& _aggregate, storage_type& rhs);
+    merge(graph_t& _aggregate, graph_t& _other);
+    merge(storage_type& lhs, graph_t& _aggregate);
+    merge(storage_type& lhs, const std::vector<storage_type*>& rhs, size_t _nthreads);
 
     // unary
     template <typename Tp>
@@ -759,10 +766,16 @@ struct print
     virtual void print_text(const std::string& fname, stream_type stream);
     virtual void print_plot(const std::string& fname, std::string suffix);
 
+    /// the stream of the messages which are written with the output files
+    std::ostream& get_console();
+    /// the manager which records the output files
+    std::shared_ptr<manager> get_manager();
+
     TIMEMORY_NODISCARD auto get_label() const { return label; }
     TIMEMORY_NODISCARD auto get_text_output_name() const { return text_outfname; }
     TIMEMORY_NODISCARD auto get_tree_output_name() const { return tree_outfname; }
     TIMEMORY_NODISCARD auto get_json_output_name() const { return json_outfname; }
+    TIMEMORY_NODISCARD auto get_binary_output_name() const { return binary_outfname; }
     TIMEMORY_NODISCARD auto get_json_input_name() const { return json_inpfname; }
     TIMEMORY_NODISCARD auto get_text_diff_name() const { return text_diffname; }
     TIMEMORY_NODISCARD auto get_json_diff_name() const { return json_diffname; }
@@ -854,6 +867,27 @@ struct print
         }
         return m_settings->get_flamegraph_output() && m_settings->get_file_output();
     }
+    bool binary_output()
+    {
+        if(!m_settings)
+        {
+            PRINT_HERE("%s", "Null pointer to settings! Disabling");
+            return false;
+        }
+        return m_settings->get_binary_output() && m_settings->get_file_output();
+    }
+    /// the JSON is written directly from the call-graph when it is the only output
+    /// which needs the results and there is a single process
+    bool json_streaming()
+    {
+        if(!m_settings)
+        {
+            PRINT_HERE("%s", "Null pointer to settings! Disabling");
+            return false;
+        }
+        return json_output() && !text_output() && !cout_output() && !binary_output() &&
+               !dart_output() && !m_settings->get_diff_output() && node_size <= 1;
+    }
 
 protected:
     // do not lint misc-non-private-member-variables-in-classes
@@ -874,11 +908,14 @@ protected:
     std::string text_outfname     = "";                                   // NOLINT
     std::string tree_outfname     = "";                                   // NOLINT
     std::string json_outfname     = "";                                   // NOLINT
+    std::string binary_outfname   = "";                                   // NOLINT
     std::string json_inpfname     = "";                                   // NOLINT
     std::string text_diffname     = "";                                   // NOLINT
     std::string json_diffname     = "";                                   // NOLINT
     stream_type data_stream       = stream_type{};                        // NOLINT
     stream_type diff_stream       = stream_type{};                        // NOLINT
+    // set when the output files are written concurrently with the other components
+    std::ostream* console = nullptr;  // NOLINT
 };
 //
 //--------------------------------------------------------------------------------------//
@@ -905,6 +942,8 @@ struct print<Tp, true> : public base::print
     using basic_tree_type          = basic_tree<node::tree<Tp>>;
     using basic_tree_vector_type   = std::vector<basic_tree_type>;
     using result_tree = std::map<std::string, std::vector<basic_tree_vector_type>>;
+    using output_task_t =
+        std::pair<std::function<void(std::ostream&)>, std::function<void()>>;
 
     static callback_type& get_default_callback()
     {
@@ -940,17 +979,36 @@ struct print<Tp, true> : public base::print
         if(node_init && node_rank > 0)
             return;
 
-        if(file_output())
-        {
-            if(json_output())
-                print_json(json_outfname, node_results, data_concurrency);
-            if(tree_output())
-                print_tree(tree_outfname, node_tree);
-            if(text_output())
-                print_text(text_outfname, data_stream);
-            if(plot_output())
-                print_plot(json_outfname, "");
-        }
+        write_files();
+        write_console();
+    }
+
+    /// gathers the results and returns the function which writes the output files
+    /// and the function which writes the console output. The former may be invoked
+    /// concurrently with the other components, see manager::write_output
+    output_task_t get_output_task();
+
+    void write_files()
+    {
+        if(!file_output())
+            return;
+
+        if(json_output() && streaming)
+            print_json(json_outfname, data_concurrency);
+        else if(json_output())
+            print_json(json_outfname, node_results, data_concurrency);
+        if(tree_output())
+            print_tree(tree_outfname, node_tree);
+        if(binary_output())
+            print_binary(binary_outfname, node_results, data_concurrency);
+        if(text_output())
+            print_text(text_outfname, data_stream);
+    }
+
+    void write_console()
+    {
+        if(file_output() && plot_output())
+            print_plot(json_outfname, "");
 
         if(cout_output())
         {
@@ -1000,6 +1058,8 @@ struct print<Tp, true> : public base::print
     }
 
     void update_data() override;
+    void collect_data();
+    void process_data();
     void setup() override;
     void read_json() override;
 
@@ -1018,6 +1078,17 @@ struct print<Tp, true> : public base::print
 
     void write_stream(stream_type& stream, result_type& results);
     void print_json(const std::string& fname, result_type& results, int64_t concurrency);
+    void print_json(const std::string& fname, int64_t concurrency);
+
+    template <typename Up = Tp, typename Vp = decay_t<decltype(std::declval<Up>().get())>,
+              enable_if_t<(tim::binary_output::value_width<Vp>::value > 0), int> = 0>
+    void print_binary(const std::string& fname, const result_type& results,
+                      int64_t concurrency);
+
+    template <typename Up = Tp, typename Vp = decay_t<decltype(std::declval<Up>().get())>,
+              enable_if_t<tim::binary_output::value_width<Vp>::value == 0, int> = 0>
+    void print_binary(const std::string&, const result_type&, int64_t)
+    {}
     TIMEMORY_NODISCARD const auto& get_data() const { return data; }
     TIMEMORY_NODISCARD const auto& get_node_results() const { return node_results; }
     TIMEMORY_NODISCARD const auto& get_node_input() const { return node_input; }
@@ -1042,11 +1113,16 @@ struct print<Tp, true> : public base::print
 protected:
     // do not lint misc-non-private-member-variables-in-classes
     storage_type* data         = nullptr;                 // NOLINT
+    bool          streaming    = false;                   // NOLINT
     callback_type callback     = get_default_callback();  // NOLINT
     result_type   node_results = {};                      // NOLINT
     result_type   node_input   = {};                      // NOLINT
     result_type   node_delta   = {};                      // NOLINT
     result_tree   node_tree    = {};                      // NOLINT
+
+private:
+    template <typename FuncT>
+    void write_json(const std::string& fname, int64_t concurrency, FuncT&& _ranks);
 };
 //
 //--------------------------------------------------------------------------------------//
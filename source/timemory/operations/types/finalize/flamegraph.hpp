@@ -57,20 +57,22 @@ struct flamegraph
     using graph_node               = typename storage_type::graph_node;
     using hierarchy_type           = typename storage_type::uintvector_t;
 
+    /// the message of the output file is written to the stream
     template <typename Up                                             = Type,
               enable_if_t<trait::supports_flamegraph<Up>::value, int> = 0>
-    flamegraph(storage_type*, std::string);
+    flamegraph(storage_type*, std::string, std::ostream& = std::cout);
 
     template <typename Up                                              = Type,
               enable_if_t<!trait::supports_flamegraph<Up>::value, int> = 0>
-    flamegraph(storage_type*, std::string);
+    flamegraph(storage_type*, std::string, std::ostream& = std::cout);
 };
 //
 //--------------------------------------------------------------------------------------//
 //
 template <typename Type>
 template <typename Up, enable_if_t<trait::supports_flamegraph<Up>::value, int>>
-flamegraph<Type>::flamegraph(storage_type* _data, std::string _label)  // NOLINT
+flamegraph<Type>::flamegraph(storage_type* _data, std::string _label,  // NOLINT
+                             std::ostream& _os)
 {
     // auto node_init        = dmp::is_initialized();
     // auto node_size        = dmp::size();
@@ -107,8 +109,8 @@ flamegraph<Type>::flamegraph(storage_type* _data, std::string _label)  // NOLINT
         if(ofs)
         {
             manager::instance()->add_json_output(_label, outfname);
-            printf("[%s]|%i> Outputting '%s'...\n", _label.c_str(), node_rank,
-                   outfname.c_str());
+            _os << "[" << _label << "]|" << node_rank << "> Outputting '" << outfname
+                << "'...\n";
 
             // ensure write final block during destruction before the file is closed
             auto oa = policy_type::get(ofs);
@@ -222,7 +224,7 @@ flamegraph<Type>::flamegraph(storage_type* _data, std::string _label)  // NOLINT
 //
 template <typename Type>
 template <typename Up, enable_if_t<!trait::supports_flamegraph<Up>::value, int>>
-flamegraph<Type>::flamegraph(storage_type*, std::string)  // NOLINT
+flamegraph<Type>::flamegraph(storage_type*, std::string, std::ostream&)  // NOLINT
 {}
 //
 //--------------------------------------------------------------------------------------//
@@ -40,7 +40,10 @@
 #include "timemory/storage/types.hpp"
 #include "timemory/tpls/cereal/cereal.hpp"
 
+#include <map>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tim
@@ -98,6 +101,16 @@ struct get<Type, true>
     enable_if_t<concepts::is_output_archive<Archive>::value, Archive&> operator()(
         Archive&, metadata);
 
+    /// serializes the call-graph in the same layout as the result_type but walks the
+    /// graph and writes each entry directly to the archive instead of copying the
+    /// graph into a result_type first
+    struct streaming
+    {};
+
+    template <typename Archive>
+    enable_if_t<concepts::is_output_archive<Archive>::value, Archive&> operator()(
+        Archive&, streaming);
+
 public:
     static std::string get_identifier(const Type& _obj = Type{})
     {
@@ -221,6 +234,11 @@ private:
         return std::string{};
     }
 
+private:
+    std::string get_thread_prefix(const graph_node&);
+    std::string get_node_prefix(const graph_node&);
+    std::string get_indentation(const graph_node&);
+
 private:
     storage_type* m_storage = nullptr;
 };
@@ -251,140 +269,14 @@ get<Type, true>::operator()(result_type& ret)
 
     auto& data               = *m_storage;
     bool  _thread_scope_only = trait::thread_scope_only<Type>::value;
-    bool  _use_tid_prefix    = (!settings::collapse_threads() || _thread_scope_only);
-    bool  _use_pid_prefix    = (!settings::collapse_processes());
-    auto  _num_thr_count     = manager::get_thread_count();
-    auto  _num_pid_count     = dmp::size();
 
     data.m_node_init = dmp::is_initialized();
     data.m_node_rank = dmp::rank();
     data.m_node_size = dmp::size();
 
-    //------------------------------------------------------------------------------//
-    //
-    //  Compute the thread prefix
-    //
-    //------------------------------------------------------------------------------//
-    auto _get_thread_prefix = [&](const graph_node& itr) {
-        if(!_use_tid_prefix || itr.tid() == std::numeric_limits<uint16_t>::max())
-            return std::string(">>> ");
-
-        // prefix spacing
-        static uint16_t width = 1;
-        if(_num_thr_count > 9)
-            width = std::max(width, (uint16_t)(log10(_num_thr_count) + 1));
-        std::stringstream ss;
-        ss.fill('0');
-        ss << "|" << std::setw(width) << itr.tid() << ">>> ";
-        return ss.str();
-    };
-
-    //------------------------------------------------------------------------------//
-    //
-    //  Compute the node prefix
-    //
-    //------------------------------------------------------------------------------//
-    auto _get_node_prefix = [&](const graph_node& itr) {
-        if(!data.m_node_init || !_use_pid_prefix)
-            return _get_thread_prefix(itr);
-
-        auto _nc    = settings::node_count();  // node-count
-        auto _idx   = data.m_node_rank;
-        auto _range = std::make_pair(-1, -1);
-
-        if(_nc > 0 && _nc < data.m_node_size)
-        {
-            // calculate some size parameters and generate map of the pids to node ids
-            int32_t nmod  = _num_pid_count % _nc;
-            int32_t bins  = _num_pid_count / _nc + ((nmod == 0) ? 0 : 1);
-            int32_t bsize = _num_pid_count / bins;
-            int32_t ncnt  = 0;  // current count
-            int32_t midx  = 0;  // current bin map index
-            std::map<int32_t, std::set<int32_t>> binmap;
-            for(int32_t i = 0; i < _num_pid_count; ++i)
-            {
-                binmap[midx].insert(i);
-                // check to see if we reached the bin size
-                if(++ncnt == bsize)
-                {
-                    // set counter to zero and advance the node
-                    ncnt = 0;
-                    ++midx;
-                }
-            }
-
-            // loop over the bins
-            for(const auto& bitr : binmap)
-            {
-                // if rank is found in a bin, assing range to first and last entry
-                if(bitr.second.find(_idx) != bitr.second.end())
-                {
-                    auto vitr    = bitr.second.begin();
-                    _range.first = *vitr;
-                    vitr         = bitr.second.end();
-                    --vitr;
-                    _range.second = *vitr;
-                }
-            }
-
-            if(settings::debug())
-            {
-                std::stringstream ss;
-                for(const auto& bitr : binmap)
-                {
-                    ss << ", [" << bitr.first << "] ";
-                    std::stringstream bss;
-                    for(const auto& nitr : bitr.second)
-                        bss << ", " << nitr;
-                    ss << bss.str().substr(2);
-                }
-                std::string _msg = "Intervals: ";
-                _msg += ss.str().substr(2);
-                PRINT_HERE("[%s][pid=%i][tid=%i]> %s. range = { %i, %i }",
-                           demangle<get<Type, true>>().c_str(), (int) process::get_id(),
-                           (int) threading::get_id(), _msg.c_str(), (int) _range.first,
-                           (int) _range.second);
-            }
-        }
-
-        // prefix spacing
-        static uint16_t width = 1;
-        if(_num_pid_count > 9)
-            width = std::max(width, (uint16_t)(log10(_num_pid_count) + 1));
-        std::stringstream ss;
-        ss.fill('0');
-        if(_range.first >= 0 && _range.second >= 0)
-        {
-            ss << "|" << std::setw(width) << _range.first << ":" << std::setw(width)
-               << _range.second << _get_thread_prefix(itr);
-        }
-        else
-        {
-            ss << "|" << std::setw(width) << _idx << _get_thread_prefix(itr);
-        }
-        return ss.str();
-    };
-
-    //------------------------------------------------------------------------------//
-    //
-    //  Compute the indentation
-    //
-    //------------------------------------------------------------------------------//
     // fix up the prefix based on the actual depth
     auto _compute_modified_prefix = [&](const graph_node& itr) {
-        std::string _prefix      = data.get_prefix(itr);
-        std::string _indent      = {};
-        std::string _node_prefix = _get_node_prefix(itr);
-
-        int64_t _depth = itr.depth() - 1;
-        if(_depth > 0)
-        {
-            for(int64_t ii = 0; ii < _depth - 1; ++ii)
-                _indent += "  ";
-            _indent += "|_";
-        }
-
-        return _node_prefix + _indent + _prefix;
+        return get_node_prefix(itr) + get_indentation(itr) + data.get_prefix(itr);
     };
 
     // convert graph to a vector
@@ -445,6 +337,136 @@ get<Type, true>::operator()(result_type& ret)
 //--------------------------------------------------------------------------------------//
 //
 template <typename Type>
+std::string
+get<Type, true>::get_thread_prefix(const graph_node& itr)
+{
+    bool _thread_scope_only = trait::thread_scope_only<Type>::value;
+    bool _use_tid_prefix    = (!settings::collapse_threads() || _thread_scope_only);
+    auto _num_thr_count     = manager::get_thread_count();
+
+    if(!_use_tid_prefix || itr.tid() == std::numeric_limits<uint16_t>::max())
+        return std::string(">>> ");
+
+    // prefix spacing
+    static uint16_t width = 1;
+    if(_num_thr_count > 9)
+        width = std::max(width, (uint16_t)(log10(_num_thr_count) + 1));
+    std::stringstream ss;
+    ss.fill('0');
+    ss << "|" << std::setw(width) << itr.tid() << ">>> ";
+    return ss.str();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+std::string
+get<Type, true>::get_node_prefix(const graph_node& itr)
+{
+    auto& data            = *m_storage;
+    bool  _use_pid_prefix = (!settings::collapse_processes());
+    auto  _num_pid_count  = dmp::size();
+
+    if(!data.m_node_init || !_use_pid_prefix)
+        return get_thread_prefix(itr);
+
+    auto _nc    = settings::node_count();  // node-count
+    auto _idx   = data.m_node_rank;
+    auto _range = std::make_pair(-1, -1);
+
+    if(_nc > 0 && _nc < data.m_node_size)
+    {
+        // calculate some size parameters and generate map of the pids to node ids
+        int32_t nmod  = _num_pid_count % _nc;
+        int32_t bins  = _num_pid_count / _nc + ((nmod == 0) ? 0 : 1);
+        int32_t bsize = _num_pid_count / bins;
+        int32_t ncnt  = 0;  // current count
+        int32_t midx  = 0;  // current bin map index
+        std::map<int32_t, std::set<int32_t>> binmap;
+        for(int32_t i = 0; i < _num_pid_count; ++i)
+        {
+            binmap[midx].insert(i);
+            // check to see if we reached the bin size
+            if(++ncnt == bsize)
+            {
+                // set counter to zero and advance the node
+                ncnt = 0;
+                ++midx;
+            }
+        }
+
+        // loop over the bins
+        for(const auto& bitr : binmap)
+        {
+            // if rank is found in a bin, assing range to first and last entry
+            if(bitr.second.find(_idx) != bitr.second.end())
+            {
+                auto vitr    = bitr.second.begin();
+                _range.first = *vitr;
+                vitr         = bitr.second.end();
+                --vitr;
+                _range.second = *vitr;
+            }
+        }
+
+        if(settings::debug())
+        {
+            std::stringstream ss;
+            for(const auto& bitr : binmap)
+            {
+                ss << ", [" << bitr.first << "] ";
+                std::stringstream bss;
+                for(const auto& nitr : bitr.second)
+                    bss << ", " << nitr;
+                ss << bss.str().substr(2);
+            }
+            std::string _msg = "Intervals: ";
+            _msg += ss.str().substr(2);
+            PRINT_HERE("[%s][pid=%i][tid=%i]> %s. range = { %i, %i }",
+                       demangle<get<Type, true>>().c_str(), (int) process::get_id(),
+                       (int) threading::get_id(), _msg.c_str(), (int) _range.first,
+                       (int) _range.second);
+        }
+    }
+
+    // prefix spacing
+    static uint16_t width = 1;
+    if(_num_pid_count > 9)
+        width = std::max(width, (uint16_t)(log10(_num_pid_count) + 1));
+    std::stringstream ss;
+    ss.fill('0');
+    if(_range.first >= 0 && _range.second >= 0)
+    {
+        ss << "|" << std::setw(width) << _range.first << ":" << std::setw(width)
+           << _range.second << get_thread_prefix(itr);
+    }
+    else
+    {
+        ss << "|" << std::setw(width) << _idx << get_thread_prefix(itr);
+    }
+    return ss.str();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+std::string
+get<Type, true>::get_indentation(const graph_node& itr)
+{
+    std::string _indent = {};
+    int64_t     _depth  = itr.depth() - 1;
+    if(_depth > 0)
+    {
+        for(int64_t ii = 0; ii < _depth - 1; ++ii)
+            _indent += "  ";
+        _indent += "|_";
+    }
+    return _indent;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
 typename get<Type, true>::basic_tree_vector_type&
 get<Type, true>::operator()(basic_tree_vector_type& bt)
 {
@@ -494,6 +516,142 @@ get<Type, true>::operator()(Archive& ar, metadata)
 template <typename Type>
 template <typename Archive>
 enable_if_t<concepts::is_output_archive<Archive>::value, Archive&>
+get<Type, true>::operator()(Archive& ar, streaming)
+{
+    using stats_type  = typename graph_node::stats_type;
+    using iterator    = typename graph_type::pre_order_iterator;
+    using merged_type = std::pair<Type, stats_type>;
+
+    if(!m_storage)
+        return ar;
+
+    auto& data = *m_storage;
+    if(data.m_is_master)
+        data.merge_retired();
+
+    bool _thread_scope_only = trait::thread_scope_only<Type>::value;
+    bool _collapse          = settings::collapse_threads() && !_thread_scope_only;
+
+    data.m_node_init = dmp::is_initialized();
+    data.m_node_rank = dmp::rank();
+    data.m_node_size = dmp::size();
+
+    // the head node should always be ignored
+    int64_t _min = std::numeric_limits<int64_t>::max();
+    for(const auto& itr : data.graph())
+        _min = std::min<int64_t>(_min, itr.depth());
+
+    auto _get_rolling = [_min](iterator itr) {
+        auto _rolling = itr->id();
+        auto _parent  = graph_type::parent(itr);
+        while(_parent && _parent->depth() > _min)
+        {
+            _rolling += _parent->id();
+            _parent = graph_type::parent(_parent);
+        }
+        return _rolling;
+    };
+
+    // the node prefix only depends on the thread so it is computed once per thread
+    std::map<uint16_t, std::string> _node_prefixes{};
+    auto _write = [&](iterator itr, uint64_t _rolling, const Type& _obj,
+                      const stats_type& _stats) {
+        auto pitr = _node_prefixes.find(itr->tid());
+        if(pitr == _node_prefixes.end())
+            pitr = _node_prefixes.emplace(itr->tid(), get_node_prefix(*itr)).first;
+
+        int64_t _depth = itr->depth() - (_min + 1);
+        ar.startNode();
+        ar(cereal::make_nvp("hash", itr->id()),
+           cereal::make_nvp("prefix",
+                            pitr->second + get_indentation(*itr) + data.get_prefix(*itr)),
+           cereal::make_nvp("depth", _depth), cereal::make_nvp("entry", _obj),
+           cereal::make_nvp("stats", _stats),
+           cereal::make_nvp("rolling_hash", _rolling));
+        ar.finishNode();
+    };
+
+    if(!_collapse)
+    {
+        uint64_t _size = 0;
+        for(const auto& itr : data.graph())
+            _size += (itr.depth() > _min) ? 1 : 0;
+
+        ar(cereal::make_nvp("graph_size", _size));
+        ar.setNextName("graph");
+        ar.startNode();
+        ar.makeArray();
+        for(iterator itr = data.graph().begin(); itr != data.graph().end(); ++itr)
+        {
+            if(itr->depth() > _min)
+                _write(itr, _get_rolling(itr), itr->obj(), itr->stats());
+        }
+        ar.finishNode();
+        return ar;
+    }
+
+    // when the threads are collapsed, the entries with the same depth, hash, and
+    // rolling hash are combined into the first one in the same manner as merge on the
+    // result_type. Only the position of the first entry is stored and a copy of the
+    // data is only made for the entries which have duplicates
+    using index_map_t = std::unordered_map<
+        int64_t, std::unordered_map<uint64_t, std::unordered_map<uint64_t, size_t>>>;
+
+    index_map_t                                _index{};
+    std::vector<std::pair<iterator, uint64_t>> _unique{};
+    std::map<size_t, merged_type>              _merged{};
+
+    for(iterator itr = data.graph().begin(); itr != data.graph().end(); ++itr)
+    {
+        if(!(itr->depth() > _min))
+            continue;
+
+        auto  _rolling = _get_rolling(itr);
+        auto& _tbl     = _index[itr->depth()][itr->id()];
+        auto  citr     = _tbl.find(_rolling);
+        if(citr == _tbl.end())
+        {
+            _tbl.emplace(_rolling, _unique.size());
+            _unique.emplace_back(itr, _rolling);
+            continue;
+        }
+
+        auto _first = _unique.at(citr->second).first;
+        auto mitr   = _merged.find(citr->second);
+        if(mitr == _merged.end())
+        {
+            mitr = _merged.emplace(citr->second, merged_type{ _first->obj(),
+                                                               _first->stats() })
+                       .first;
+        }
+        auto& _obj = mitr->second.first;
+        _obj += itr->obj();
+        _obj.plus(itr->obj());
+        mitr->second.second += itr->stats();
+    }
+
+    ar(cereal::make_nvp("graph_size", _unique.size()));
+    ar.setNextName("graph");
+    ar.startNode();
+    ar.makeArray();
+    for(size_t i = 0; i < _unique.size(); ++i)
+    {
+        auto itr  = _unique.at(i).first;
+        auto mitr = _merged.find(i);
+        if(mitr == _merged.end())
+            _write(itr, _unique.at(i).second, itr->obj(), itr->stats());
+        else
+            _write(itr, _unique.at(i).second, mitr->second.first, mitr->second.second);
+    }
+    ar.finishNode();
+    return ar;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+template <typename Archive>
+enable_if_t<concepts::is_output_archive<Archive>::value, Archive&>
 get<Type, true>::operator()(Archive& ar)
 {
     if(!m_storage)
@@ -36,7 +36,13 @@
 #include "timemory/storage/basic_tree.hpp"
 #include "timemory/storage/graph.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace tim
 {
@@ -71,36 +77,25 @@ merge<Type, true>::merge(storage_type& lhs, storage_type& rhs)
     if(!l.owns_lock())
         l.lock();
 
-    auto _copy_hash_ids = [&]() {
-        for(const auto& itr : (*rhs.get_hash_ids()))
-        {
-            if(lhs.m_hash_ids->find(itr.first) == lhs.m_hash_ids->end())
-                (*lhs.m_hash_ids)[itr.first] = itr.second;
-        }
-        for(const auto& itr : (*rhs.get_hash_aliases()))
-        {
-            if(lhs.m_hash_aliases->find(itr.first) == lhs.m_hash_aliases->end())
-                (*lhs.m_hash_aliases)[itr.first] = itr.second;
-        }
-    };
-
     // if self is not initialized but itr is, copy data
     if(rhs.is_initialized() && !lhs.is_initialized())
     {
         PRINT_HERE("[%s]> Warning! master is not initialized! Segmentation fault likely",
                    Type::get_label().c_str());
+        typename storage_type::graph_data_t::modify_guard _guard{ lhs._data() };
         lhs.graph().insert_subgraph_after(lhs._data().head(), rhs.data().head());
         lhs.m_initialized = rhs.m_initialized;
         lhs.m_finalized   = rhs.m_finalized;
-        _copy_hash_ids();
         return;
     }
 
-    _copy_hash_ids();
-
     if(rhs.empty() || !rhs.data().has_head())
         return;
 
+    // concurrent snapshots of either graph retry until the merge is complete
+    typename storage_type::graph_data_t::modify_guard _lhs_guard{ lhs._data() };
+    typename storage_type::graph_data_t::modify_guard _rhs_guard{ rhs.data() };
+
     int64_t num_merged     = 0;
     auto    inverse_insert = rhs.data().get_inverse_insert();
 
@@ -175,6 +170,219 @@ merge<Type, true>::merge(storage_type& lhs, storage_type& rhs)
     }
 
     rhs.data().clear();
+    rhs.reset_cursors();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+merge<Type, true>::merge(graph_t& _graph, iterator _dst, iterator _src)
+{
+    using sibling_iterator = typename graph_t::sibling_iterator;
+
+    // fold the children of src into the children of dst. Children which match an
+    // existing child of dst are combined instead of appended as a duplicate
+    bool _use_tid =
+        !settings::collapse_threads() || trait::thread_scope_only<Type>::value;
+
+    for(sibling_iterator sitr = _src.begin(); sitr != _src.end(); ++sitr)
+    {
+        if(sitr->obj().get_laps() == 0)
+            continue;
+
+        iterator _match = nullptr;
+        for(sibling_iterator ditr = _dst.begin(); ditr != _dst.end(); ++ditr)
+        {
+            if(*ditr == *sitr && (!_use_tid || ditr->tid() == sitr->tid()))
+            {
+                _match = ditr;
+                break;
+            }
+        }
+
+        if(_match)
+        {
+            _match->obj() += sitr->obj();
+            _match->obj().plus(sitr->obj());
+            _match->stats() += sitr->stats();
+            merge(_graph, _match, sitr);
+        }
+        else
+        {
+            _graph.append_child(_dst, iterator{ sitr });
+        }
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+merge<Type, true>::merge(graph_t& _aggregate, storage_type& rhs)
+{
+    using sibling_iterator = typename graph_t::sibling_iterator;
+
+    if(!rhs.m_graph_data_instance || rhs.empty() || !rhs.data().has_head())
+        return;
+
+    // the top-level nodes of the aggregate are the bookmarks of the workers,
+    // i.e. the location in the master graph where the worker was attached
+    for(auto& bitr : rhs.data().get_inverse_insert())
+    {
+        iterator _pos = nullptr;
+        for(sibling_iterator sitr = _aggregate.begin(); sitr != _aggregate.end(); ++sitr)
+        {
+            if(*sitr == *bitr.second)
+            {
+                _pos = sitr;
+                break;
+            }
+        }
+
+        if(!_pos)
+        {
+            auto _node = *bitr.second;
+            _pos       = (_aggregate.empty())
+                       ? _aggregate.set_head(_node)
+                       : _aggregate.insert_after(_aggregate.begin(), _node);
+        }
+
+        merge(_aggregate, _pos, bitr.second);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+merge<Type, true>::merge(graph_t& _aggregate, graph_t& _other)
+{
+    using sibling_iterator = typename graph_t::sibling_iterator;
+
+    for(sibling_iterator oitr = _other.begin(); oitr != _other.end(); ++oitr)
+    {
+        iterator _pos = nullptr;
+        for(sibling_iterator sitr = _aggregate.begin(); sitr != _aggregate.end(); ++sitr)
+        {
+            if(*sitr == *oitr)
+            {
+                _pos = sitr;
+                break;
+            }
+        }
+
+        if(!_pos)
+        {
+            auto _node = *oitr;
+            _pos       = (_aggregate.empty())
+                       ? _aggregate.set_head(_node)
+                       : _aggregate.insert_after(_aggregate.begin(), _node);
+        }
+
+        merge(_aggregate, _pos, oitr);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+merge<Type, true>::merge(storage_type& lhs, graph_t& _aggregate)
+{
+    using sibling_iterator = typename graph_t::sibling_iterator;
+
+    typename storage_type::graph_data_t::modify_guard _guard{ lhs._data() };
+    for(sibling_iterator sitr = _aggregate.begin(); sitr != _aggregate.end(); ++sitr)
+    {
+        auto _pos = lhs._data().find(sitr);
+        if(_pos == lhs._data().end())
+            _pos = lhs._data().head();
+        merge(lhs._data().graph(), _pos, sitr);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+merge<Type, true>::merge(storage_type& lhs, const std::vector<storage_type*>& rhs,
+                         size_t _nthreads)
+{
+    // runs _func(i) for i in [0, _n) on up to _nthreads threads
+    auto _parallel = [_nthreads](size_t _n, const std::function<void(size_t)>& _func) {
+        auto _nt = std::min<size_t>(_nthreads, _n);
+        if(_nt < 2)
+        {
+            for(size_t i = 0; i < _n; ++i)
+                _func(i);
+            return;
+        }
+
+        std::atomic<size_t>      _idx{ 0 };
+        std::vector<std::thread> _threads{};
+        for(size_t i = 0; i < _nt; ++i)
+        {
+            _threads.emplace_back([&]() {
+                size_t _i = 0;
+                while((_i = _idx++) < _n)
+                    _func(_i);
+            });
+        }
+        for(auto& itr : _threads)
+            itr.join();
+    };
+
+    std::vector<storage_type*> _workers{};
+    for(auto* itr : rhs)
+    {
+        if(!itr || itr == &lhs || !itr->is_initialized())
+            continue;
+
+        // workers without a bookmark in the master graph use the serial merge
+        if(!lhs.is_initialized() || !itr->m_graph_data_instance || itr->empty() ||
+           !itr->data().has_head() || itr->data().get_inverse_insert().empty())
+        {
+            merge(lhs, *itr);
+            continue;
+        }
+
+        itr->stack_clear();
+        _workers.emplace_back(itr);
+    }
+
+    if(_workers.empty())
+        return;
+
+    // create lock
+    auto_lock_t l(singleton_t::get_mutex(), std::defer_lock);
+    if(!l.owns_lock())
+        l.lock();
+
+    if(settings::debug() || settings::verbose() > 2)
+    {
+        PRINT_HERE("[%s]> merging %i workers on %i threads", Type::get_label().c_str(),
+                   (int) _workers.size(), (int) _nthreads);
+    }
+
+    // fold each worker into its own aggregate and release the worker graph
+    auto                                  _n = _workers.size();
+    std::vector<std::unique_ptr<graph_t>> _aggregates(_n);
+    _parallel(_n, [&](size_t i) {
+        _aggregates.at(i) = std::make_unique<graph_t>();
+        merge(*_aggregates.at(i), *_workers.at(i));
+        _workers.at(i)->data().clear();
+        _workers.at(i)->reset_cursors();
+    });
+
+    // pairwise reduction of the aggregates, i.e. log2(N) rounds
+    for(size_t _stride = 1; _stride < _n; _stride *= 2)
+    {
+        auto _npairs = (_n + _stride - 1) / (2 * _stride);
+        _parallel(_npairs, [&](size_t i) {
+            auto _lidx = 2 * _stride * i;
+            auto _ridx = _lidx + _stride;
+            merge(*_aggregates.at(_lidx), *_aggregates.at(_ridx));
+            _aggregates.at(_ridx).reset();
+        });
+    }
+
+    merge(lhs, *_aggregates.front());
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -483,23 +691,9 @@ merge<Type, true>::operator()(GraphT& _g, ItrT _root, ItrT _rhs)
 template <typename Type>
 merge<Type, false>::merge(storage_type& lhs, storage_type& rhs)
 {
+    // the hash ids and aliases are shared by all threads so there is nothing to copy
+    (void) lhs;
     rhs.stack_clear();
-
-    // create lock
-    auto_lock_t l(singleton_t::get_mutex(), std::defer_lock);
-    if(!l.owns_lock())
-        l.lock();
-
-    for(const auto& itr : *rhs.get_hash_ids())
-    {
-        if(lhs.m_hash_ids->find(itr.first) == lhs.m_hash_ids->end())
-            (*lhs.m_hash_ids)[itr.first] = itr.second;
-    }
-    for(const auto& itr : (*rhs.get_hash_aliases()))
-    {
-        if(lhs.m_hash_aliases->find(itr.first) == lhs.m_hash_aliases->end())
-            (*lhs.m_hash_aliases)[itr.first] = itr.second;
-    }
 }
 //
 //--------------------------------------------------------------------------------------//
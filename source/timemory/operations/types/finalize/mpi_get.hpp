@@ -172,8 +172,7 @@ mpi_get<Type, true>::operator()(distrib_type& results)
 
     results = distrib_type(comm_size);
 
-    auto ret     = data.get();
-    auto str_ret = send_serialize(ret);
+    auto ret = data.get();
 
     if(comm_rank == 0)
     {
@@ -194,6 +193,8 @@ mpi_get<Type, true>::operator()(distrib_type& results)
     }
     else
     {
+        // only the non-root ranks need the serialized copy
+        auto str_ret = send_serialize(ret);
         //
         //  The non-root rank sends its data to the root rank and only reports own data
         //
@@ -34,6 +34,7 @@
 #include "timemory/plotting/declaration.hpp"
 #include "timemory/settings/declaration.hpp"
 
+#include <array>
 #include <cstdint>
 #include <fstream>
 #include <iomanip>
@@ -96,10 +97,10 @@ base::print::print_text(const std::string& outfname, stream_type stream)  // NOL
         std::ofstream fout(outfname.c_str());
         if(fout)
         {
-            printf("[%s]|%i> Outputting '%s'...\n", label.c_str(), node_rank,
-                   outfname.c_str());
+            get_console() << "[" << label << "]|" << node_rank << "> Outputting '"
+                          << outfname << "'...\n";
             write(fout, stream);
-            manager::instance()->add_text_output(label, outfname);
+            get_manager()->add_text_output(label, outfname);
         }
         else
         {
@@ -111,6 +112,23 @@ base::print::print_text(const std::string& outfname, stream_type stream)  // NOL
 //
 //--------------------------------------------------------------------------------------//
 //
+TIMEMORY_OPERATIONS_LINKAGE(std::ostream&)
+base::print::get_console()  // NOLINT
+{
+    return (console) ? *console : std::cout;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+TIMEMORY_OPERATIONS_LINKAGE(std::shared_ptr<manager>)
+base::print::get_manager()  // NOLINT
+{
+    // the output files are written on another thread when the console is set
+    return (console) ? manager::master_instance() : manager::instance();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
 #endif  // !defined(TIMEMORY_OPERATIONS_SOURCE)
 //
 template <typename Tp>
@@ -195,8 +213,8 @@ print<Tp, true>::setup()
         }
     }
 
-    auto file_exists = [](const std::string& fname) {
-        std::cout << "Checking for existing input at " << fname << "...\n";
+    auto file_exists = [this](const std::string& fname) {
+        get_console() << "Checking for existing input at " << fname << "...\n";
         std::ifstream inpf(fname.c_str());
         auto          success = inpf.is_open();
         inpf.close();
@@ -210,6 +228,8 @@ print<Tp, true>::setup()
     json_outfname = settings::compose_output_filename(label, fext);
     text_outfname = settings::compose_output_filename(label, ".txt");
 
+    binary_outfname = settings::compose_output_filename(label, ".bin");
+
     if(m_settings->get_diff_output())
     {
         extensions.insert(extensions.begin(), fext);
@@ -231,8 +251,8 @@ print<Tp, true>::setup()
         text_diffname = settings::compose_output_filename(label, ".diff.txt");
         if(m_settings->get_debug())
         {
-            printf("difference filenames: '%s' and '%s'\n", json_diffname.c_str(),
-                   text_diffname.c_str());
+            get_console() << "difference filenames: '" << json_diffname << "' and '"
+                          << text_diffname << "'\n";
         }
     }
 
@@ -356,12 +376,28 @@ print<Tp, true>::write_stream(stream_type& stream, result_type& result_array)
 template <typename Tp>
 void
 print<Tp, true>::update_data()
+{
+    collect_data();
+    process_data();
+
+    if(flame_output())
+        operation::finalize::flamegraph<Tp>(data, label);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+void
+print<Tp, true>::collect_data()
 {
     dmp::barrier();
-    node_init    = dmp::is_initialized();
-    node_rank    = dmp::rank();
-    node_size    = dmp::size();
-    node_results = data->dmp_get();
+    node_init = dmp::is_initialized();
+    node_rank = dmp::rank();
+    node_size = dmp::size();
+    // avoid the copy of the call-graph when the JSON can be written from the graph
+    streaming = json_streaming();
+    if(!streaming)
+        node_results = data->dmp_get();
     if(tree_output())
         node_tree = data->dmp_get(node_tree);
     data_concurrency = data->instance_count().load();
@@ -372,7 +408,14 @@ print<Tp, true>::update_data()
         printf("[%s]|%i> dmp results size: %i\n", label.c_str(), node_rank,
                (int) node_results.size());
     }
-
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+void
+print<Tp, true>::process_data()
+{
     setup();
 
     read_json();
@@ -436,9 +479,50 @@ print<Tp, true>::update_data()
         printf("\n");
     }
 #endif
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+typename print<Tp, true>::output_task_t
+print<Tp, true>::get_output_task()
+{
+    if(!data)
+        return output_task_t{};
 
-    if(flame_output())
-        operation::finalize::flamegraph<Tp>(data, label);
+    // the gathers may communicate with the other processes. The message of the
+    // flamegraph is written after the messages of process_data, same as update_data
+    auto _flame = std::make_shared<std::stringstream>();
+    if(update)
+    {
+        collect_data();
+        if(flame_output())
+            operation::finalize::flamegraph<Tp>(data, label, *_flame);
+    }
+
+    auto _write = [this, _flame](std::ostream& _os) {
+        console = &_os;
+        if(update)
+        {
+            process_data();
+            _os << _flame->str();
+        }
+        else
+        {
+            setup();
+        }
+        if(!node_init || node_rank == 0)
+            write_files();
+        console = nullptr;
+    };
+
+    auto _print = [this]() {
+        console = nullptr;
+        if(!node_init || node_rank == 0)
+            write_console();
+    };
+
+    return output_task_t{ _write, _print };
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -462,6 +546,52 @@ template <typename Tp>
 void
 print<Tp, true>::print_json(const std::string& outfname, result_type& results,
                             int64_t concurrency)
+{
+    write_json(outfname, concurrency, [&results](auto& oa) {
+        for(uint64_t i = 0; i < results.size(); ++i)
+        {
+            if(results.at(i).empty())
+                continue;
+
+            oa.startNode();
+
+            oa(cereal::make_nvp("rank", i));
+            save(oa, results.at(i));
+
+            oa.finishNode();
+        }
+    });
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+void
+print<Tp, true>::print_json(const std::string& outfname, int64_t concurrency)
+{
+    using get_type = get<Tp, true>;
+
+    // same layout as the results of a single rank
+    write_json(outfname, concurrency, [this](auto& oa) {
+        if(data->empty())
+            return;
+
+        oa.startNode();
+
+        oa(cereal::make_nvp("rank", uint64_t{ 0 }));
+        get_type{ data }(oa, typename get_type::streaming{});
+
+        oa.finishNode();
+    });
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+template <typename FuncT>
+void
+print<Tp, true>::write_json(const std::string& outfname, int64_t concurrency,
+                            FuncT&& _ranks)
 {
     using policy_type = policy::output_archive_t<Tp>;
     if(outfname.length() > 0)
@@ -472,9 +602,9 @@ print<Tp, true>::print_json(const std::string& outfname, result_type& results,
             auto fext = outfname.substr(outfname.find_last_of('.') + 1);
             if(fext.empty())
                 fext = "unknown";
-            manager::instance()->add_file_output(fext, label, outfname);
-            printf("[%s]|%i> Outputting '%s'...\n", label.c_str(), node_rank,
-                   outfname.c_str());
+            get_manager()->add_file_output(fext, label, outfname);
+            get_console() << "[" << label << "]|" << node_rank << "> Outputting '"
+                          << outfname << "'...\n";
 
             // ensure write final block during destruction before the file is closed
             auto oa = policy_type::get(ofs);
@@ -495,18 +625,7 @@ print<Tp, true>::print_json(const std::string& outfname, result_type& results,
             oa->setNextName("ranks");
             oa->startNode();
             oa->makeArray();
-            for(uint64_t i = 0; i < results.size(); ++i)
-            {
-                if(results.at(i).empty())
-                    continue;
-
-                oa->startNode();
-
-                (*oa)(cereal::make_nvp("rank", i));
-                save(*oa, results.at(i));
-
-                oa->finishNode();
-            }
+            std::forward<FuncT>(_ranks)(*oa);
             oa->finishNode();  // ranks
             oa->finishNode();  // name
             oa->finishNode();  // timemory
@@ -532,9 +651,9 @@ print<Tp, true>::print_tree(const std::string& outfname, result_tree& rt)
         auto fext = outfname.substr(outfname.find_last_of('.') + 1);
         if(fext.empty())
             fext = "unknown";
-        manager::instance()->add_file_output(fext, label, outfname);
-        printf("[%s]|%i> Outputting '%s'...\n", label.c_str(), node_rank,
-               outfname.c_str());
+        get_manager()->add_file_output(fext, label, outfname);
+        get_console() << "[" << label << "]|" << node_rank << "> Outputting '"
+                      << outfname << "'...\n";
         std::ofstream ofs(outfname.c_str());
         {
             // ensure write final block during destruction before the file is closed
@@ -566,6 +685,63 @@ print<Tp, true>::print_tree(const std::string& outfname, result_tree& rt)
 //--------------------------------------------------------------------------------------//
 //
 template <typename Tp>
+template <typename Up, typename Vp,
+          enable_if_t<(tim::binary_output::value_width<Vp>::value > 0), int>>
+void
+print<Tp, true>::print_binary(const std::string& outfname, const result_type& results,
+                              int64_t concurrency)
+{
+    namespace binary         = tim::binary_output;
+    constexpr size_t nvalues = binary::value_width<Vp>::value;
+
+    if(outfname.empty())
+        return;
+
+    std::ofstream ofs(outfname.c_str(), std::ios::out | std::ios::binary);
+    if(!ofs)
+    {
+        fprintf(stderr, "[storage<%s>::%s @ %i]|%i> Error opening '%s'...\n",
+                label.c_str(), __FUNCTION__, __LINE__, node_rank, outfname.c_str());
+        return;
+    }
+
+    get_manager()->add_file_output("bin", label, outfname);
+    get_console() << "[" << label << "]|" << node_rank << "> Outputting '" << outfname
+                  << "'...\n";
+
+    uint64_t _nranks = 0;
+    for(const auto& itr : results)
+        _nranks += (itr.empty()) ? 0 : 1;
+
+    binary::metadata _meta{};
+    _meta.label       = label;
+    _meta.description = Tp::get_description();
+    _meta.unit        = binary::get_unit<Up>(0);
+    _meta.concurrency = concurrency;
+
+    binary::writer              _writer{ ofs, _meta, nvalues, _nranks };
+    std::array<double, nvalues> _values{};
+    for(uint64_t i = 0; i < results.size(); ++i)
+    {
+        if(results.at(i).empty())
+            continue;
+
+        _writer.write_rank(i, results.at(i).size());
+        for(const auto& itr : results.at(i))
+        {
+            const auto& _obj  = itr.data();
+            auto        _laps = static_cast<uint64_t>(_obj.get_laps());
+            binary::flatten(_values.data(), _obj.get());
+            _writer.write_node(
+                { itr.hash(), itr.depth(), _laps, itr.tid(), itr.pid(), 0 },
+                itr.prefix(), _values.data());
+        }
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
 void
 print<Tp, true>::print_dart()
 {
@@ -619,8 +795,8 @@ print<Tp, true>::read_json()
         std::ifstream ifs(json_inpfname.c_str());
         if(ifs)
         {
-            printf("[%s]|%i> Reading '%s'...\n", label.c_str(), node_rank,
-                   json_inpfname.c_str());
+            get_console() << "[" << label << "]|" << node_rank << "> Reading '"
+                          << json_inpfname << "'...\n";
 
             cereal::size_type num_ranks = 0;
             // ensure write final block during destruction before the file is closed
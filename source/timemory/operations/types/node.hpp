@@ -36,6 +36,7 @@
 #include "timemory/operations/types/add_secondary.hpp"
 #include "timemory/operations/types/add_statistics.hpp"
 #include "timemory/operations/types/math.hpp"
+#include "timemory/storage/event_trace.hpp"
 
 namespace tim
 {
@@ -96,6 +97,14 @@ private:
         {
             _obj.set_is_on_stack(true);
             _obj.set_is_flat(_scope.is_flat() || force_flat_v);
+            // traced components are not inserted into the call-graph
+            if(event_trace::enabled())
+            {
+                _obj.set_iterator(nullptr);
+                _obj.set_depth_change(false);
+                event_trace::push(_obj, _hash);
+                return;
+            }
             auto _storage = static_cast<storage_type*>(_obj.get_storage());
             if(_storage)
             {
@@ -161,6 +170,23 @@ private:
     {
         using storage_type = StorageT;
         // obj.pop_node(std::forward<Args>(args)...);
+        if(_obj.get_is_on_stack() && !_obj.get_iterator())
+        {
+            if(event_trace::pop(_obj))
+            {
+                _obj.set_is_on_stack(false);
+                return;
+            }
+            // calls beneath a collapsed call are not inserted and their value is
+            // included in the value of the outermost collapsed call
+            auto _storage = static_cast<storage_type*>(_obj.get_storage());
+            if(_storage && _storage->pop_collapsed())
+            {
+                _obj.set_is_on_stack(false);
+                _storage->stack_pop(&_obj);
+            }
+            return;
+        }
         if(_obj.get_is_on_stack() && _obj.get_iterator())
         {
             _obj.set_is_on_stack(false);
@@ -143,6 +143,37 @@
 //
 //--------------------------------------------------------------------------------------//
 //
+#if !defined(TIMEMORY_SETTINGS_CACHED_MEMBER_DEF)
+// settings queried for every measurement read the value through the pointer in
+// settings::hot_data and only fall back to the map lookup when it is not assigned
+#    define TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(TYPE, FUNC, ENV_VAR)                     \
+        TIMEMORY_SETTINGS_INLINE TYPE& settings::get_##FUNC()                            \
+        {                                                                                \
+            if(m_hot_data.FUNC)                                                          \
+                return *m_hot_data.FUNC;                                                 \
+            return static_cast<tsettings<TYPE>*>(m_data.at(ENV_VAR).get())->get();       \
+        }                                                                                \
+                                                                                         \
+        TIMEMORY_SETTINGS_INLINE TYPE settings::get_##FUNC() const                       \
+        {                                                                                \
+            if(m_hot_data.FUNC)                                                          \
+                return *m_hot_data.FUNC;                                                 \
+            auto ret = m_data.find(ENV_VAR);                                             \
+            if(ret == m_data.end())                                                      \
+                return TYPE{};                                                           \
+            if(!ret->second)                                                             \
+                return TYPE{};                                                           \
+            return static_cast<tsettings<TYPE>*>(ret->second.get())->get();              \
+        }                                                                                \
+                                                                                         \
+        TIMEMORY_SETTINGS_INLINE TYPE& settings::FUNC()                                  \
+        {                                                                                \
+            return instance<TIMEMORY_API>()->get_##FUNC();                               \
+        }
+#endif
+//
+//--------------------------------------------------------------------------------------//
+//
 #if !defined(TIMEMORY_SETTINGS_MEMBER_IMPL)
 #    define TIMEMORY_SETTINGS_MEMBER_IMPL(TYPE, FUNC, ENV_VAR, DESC, INIT)               \
                                                                                          \
@@ -382,6 +382,7 @@ settings::settings(const settings& rhs)
             }
         }
     }
+    update_hot_data();
 }
 //
 //----------------------------------------------------------------------------------//
@@ -414,6 +415,7 @@ settings::operator=(const settings& rhs)
             }
         }
     }
+    update_hot_data();
     return *this;
 }
 //
@@ -473,6 +475,30 @@ settings::initialize_core()
         uint16_t, max_depth, TIMEMORY_SETTINGS_KEY("MAX_DEPTH"),
         "Set the maximum depth of label hierarchy reporting",
         std::numeric_limits<uint16_t>::max(), strvector_t({ "--timemory-max-depth" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        bool, event_trace, TIMEMORY_SETTINGS_KEY("EVENT_TRACE"),
+        "Record the start and stop of every component in a time-ordered binary trace "
+        "instead of inserting them into the call-graph",
+        false, strvector_t({ "--timemory-event-trace" }), -1, 1);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        size_t, event_trace_buffer_size, TIMEMORY_SETTINGS_KEY("EVENT_TRACE_BUFFER_SIZE"),
+        "Number of events in the ring buffer of each thread when event tracing is "
+        "enabled (rounded up to a power of two)",
+        65536);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        string_t, event_trace_overflow, TIMEMORY_SETTINGS_KEY("EVENT_TRACE_OVERFLOW"),
+        "Action when the event trace buffer of a thread is full: 'drop' the new event, "
+        "'overwrite' the oldest event or 'block' until the buffer is written",
+        "drop");
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        bool, chrome_trace_output, TIMEMORY_SETTINGS_KEY("CHROME_TRACE_OUTPUT"),
+        "Convert the event trace into the Trace Event Format (JSON) for "
+        "chrome://tracing and Perfetto when event tracing is enabled",
+        true);
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -600,6 +626,12 @@ settings::initialize_io()
         "Write a json output for flamegraph visualization (use chrome://tracing)", true,
         strvector_t({ "--timemory-flamegraph-output" }), -1, 1);
 
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        bool, binary_output, TIMEMORY_SETTINGS_KEY("BINARY_OUTPUT"),
+        "Write a compact binary output of the results of each component (see "
+        "timemory.binary in python for a reader and a converter to json)",
+        false, strvector_t({ "--timemory-binary-output" }), -1, 1);
+
     TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
         bool, ctest_notes, TIMEMORY_SETTINGS_KEY("CTEST_NOTES"),
         "Write a CTestNotes.txt for each text output", false,
@@ -723,6 +755,52 @@ settings::initialize_parallel()
         " the master thread. Higher values tend to increase the finalization merge time",
         50);
 
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        bool, incremental_merge, TIMEMORY_SETTINGS_KEY("INCREMENTAL_MERGE"),
+        "Fold the call-graph of an exiting worker thread into a combined aggregate and "
+        "release its memory instead of appending it to the call-graph of the master",
+        false);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        size_t, parallel_merge, TIMEMORY_SETTINGS_KEY("PARALLEL_MERGE"),
+        "Number of threads used to combine the call-graphs of the worker threads at "
+        "finalization via a pairwise reduction. Values less than two use a serial merge",
+        0);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        size_t, parallel_output, TIMEMORY_SETTINGS_KEY("PARALLEL_OUTPUT"),
+        "Number of threads used to write the output files of the components at "
+        "finalization. The console output is written in the same order as the serial "
+        "output. Values less than two write the output serially",
+        0);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        size_t, node_limit, TIMEMORY_SETTINGS_KEY("NODE_LIMIT"),
+        "Maximum number of call-graph nodes of a component across all threads (0 = no "
+        "limit). New entries past the limit are combined into an [other] node",
+        0);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        size_t, thread_node_limit, TIMEMORY_SETTINGS_KEY("THREAD_NODE_LIMIT"),
+        "Maximum number of call-graph nodes of a component on each thread (0 = no "
+        "limit). New entries past the limit are combined into an [other] node",
+        0);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        double, collapse_threshold, TIMEMORY_SETTINGS_KEY("COLLAPSE_THRESHOLD"),
+        "Average cost per call (in the display units of the component) below which a "
+        "frequently called call-graph node is folded into its parent: its later calls "
+        "are combined into a [collapsed] child of the parent and the calls beneath "
+        "them are not recorded (0 = disabled)",
+        0.0);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        size_t, collapse_min_laps, TIMEMORY_SETTINGS_KEY("COLLAPSE_MIN_LAPS"),
+        "Number of calls to a call-graph node before it is considered for collapsing "
+        "w.r.t. the collapse threshold. It is re-evaluated every time this number of "
+        "calls is reached",
+        10000);
+
     TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
         bool, collapse_threads, TIMEMORY_SETTINGS_KEY("COLLAPSE_THREADS"),
         "Enable/disable combining thread-specific data", true,
@@ -955,6 +1033,24 @@ settings::initialize_miscellaneous()
         "throttling",
         10000, strvector_t({ "--timemory-throttle-value" }), 1);
 
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        bool, adaptive_throttle, TIMEMORY_SETTINGS_KEY("ADAPTIVE_THROTTLE"),
+        "Instead of permanently throttling cheap instrumented functions, measure one in N "
+        "of their calls, where N doubles while the function remains below the throttle "
+        "value and is reset to one when its runtime rises above it",
+        false);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        double, throttle_budget, TIMEMORY_SETTINGS_KEY("THROTTLE_BUDGET"),
+        "Fraction of the runtime of a thread which the instrumentation should stay under "
+        "when adaptive throttling is enabled. Above it, the sampling of the functions is "
+        "reduced regardless of their runtime",
+        0.02);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        size_t, throttle_max_period, TIMEMORY_SETTINGS_KEY("THROTTLE_MAX_PERIOD"),
+        "Maximum N when adaptive throttling measures one in N calls of a function", 1024);
+
     TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
         bool, enable_signal_handler, TIMEMORY_SETTINGS_KEY("ENABLE_SIGNAL_HANDLER"),
         "Enable signals in timemory_init", false,
@@ -1102,6 +1198,28 @@ settings::initialize()
     initialize_miscellaneous();
     initialize_ert();
     initialize_dart();
+    update_hot_data();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+TIMEMORY_SETTINGS_INLINE
+void
+settings::update_hot_data()
+{
+    auto& _hot     = m_hot_data;
+    _hot.enabled   = get_value_pointer<bool>(TIMEMORY_SETTINGS_KEY("ENABLED"));
+    _hot.debug     = get_value_pointer<bool>(TIMEMORY_SETTINGS_KEY("DEBUG"));
+    _hot.verbose   = get_value_pointer<int>(TIMEMORY_SETTINGS_KEY("VERBOSE"));
+    _hot.max_depth = get_value_pointer<uint16_t>(TIMEMORY_SETTINGS_KEY("MAX_DEPTH"));
+    _hot.add_secondary =
+        get_value_pointer<bool>(TIMEMORY_SETTINGS_KEY("ADD_SECONDARY"));
+    _hot.destructor_report =
+        get_value_pointer<bool>(TIMEMORY_SETTINGS_KEY("DESTRUCTOR_REPORT"));
+    _hot.throttle_count =
+        get_value_pointer<size_t>(TIMEMORY_SETTINGS_KEY("THROTTLE_COUNT"));
+    _hot.throttle_value =
+        get_value_pointer<size_t>(TIMEMORY_SETTINGS_KEY("THROTTLE_VALUE"));
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -1247,7 +1365,7 @@ TIMEMORY_SETTINGS_MEMBER_DEF(bool, suppress_parsing,
                              TIMEMORY_SETTINGS_KEY("SUPPRESS_PARSING"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, suppress_config,
                              TIMEMORY_SETTINGS_KEY("SUPPRESS_CONFIG"))
-TIMEMORY_SETTINGS_MEMBER_DEF(bool, enabled, TIMEMORY_SETTINGS_KEY("ENABLED"))
+TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(bool, enabled, TIMEMORY_SETTINGS_KEY("ENABLED"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, auto_output, TIMEMORY_SETTINGS_KEY("AUTO_OUTPUT"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, cout_output, TIMEMORY_SETTINGS_KEY("COUT_OUTPUT"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, file_output, TIMEMORY_SETTINGS_KEY("FILE_OUTPUT"))
@@ -1260,15 +1378,24 @@ TIMEMORY_SETTINGS_MEMBER_DEF(bool, plot_output, TIMEMORY_SETTINGS_KEY("PLOT_OUTP
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, diff_output, TIMEMORY_SETTINGS_KEY("DIFF_OUTPUT"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, flamegraph_output,
                              TIMEMORY_SETTINGS_KEY("FLAMEGRAPH_OUTPUT"))
+TIMEMORY_SETTINGS_MEMBER_DEF(bool, binary_output, TIMEMORY_SETTINGS_KEY("BINARY_OUTPUT"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, ctest_notes, TIMEMORY_SETTINGS_KEY("CTEST_NOTES"))
-TIMEMORY_SETTINGS_MEMBER_DEF(int, verbose, TIMEMORY_SETTINGS_KEY("VERBOSE"))
-TIMEMORY_SETTINGS_MEMBER_DEF(bool, debug, TIMEMORY_SETTINGS_KEY("DEBUG"))
+TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(int, verbose, TIMEMORY_SETTINGS_KEY("VERBOSE"))
+TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(bool, debug, TIMEMORY_SETTINGS_KEY("DEBUG"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, banner, TIMEMORY_SETTINGS_KEY("BANNER"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, collapse_threads,
                              TIMEMORY_SETTINGS_KEY("COLLAPSE_THREADS"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, collapse_processes,
                              TIMEMORY_SETTINGS_KEY("COLLAPSE_PROCESSES"))
-TIMEMORY_SETTINGS_MEMBER_DEF(uint16_t, max_depth, TIMEMORY_SETTINGS_KEY("MAX_DEPTH"))
+TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(uint16_t, max_depth,
+                                    TIMEMORY_SETTINGS_KEY("MAX_DEPTH"))
+TIMEMORY_SETTINGS_MEMBER_DEF(bool, event_trace, TIMEMORY_SETTINGS_KEY("EVENT_TRACE"))
+TIMEMORY_SETTINGS_MEMBER_DEF(size_t, event_trace_buffer_size,
+                             TIMEMORY_SETTINGS_KEY("EVENT_TRACE_BUFFER_SIZE"))
+TIMEMORY_SETTINGS_MEMBER_DEF(string_t, event_trace_overflow,
+                             TIMEMORY_SETTINGS_KEY("EVENT_TRACE_OVERFLOW"))
+TIMEMORY_SETTINGS_MEMBER_DEF(bool, chrome_trace_output,
+                             TIMEMORY_SETTINGS_KEY("CHROME_TRACE_OUTPUT"))
 TIMEMORY_SETTINGS_MEMBER_DEF(string_t, time_format, TIMEMORY_SETTINGS_KEY("TIME_FORMAT"))
 TIMEMORY_SETTINGS_MEMBER_DEF(int16_t, precision, TIMEMORY_SETTINGS_KEY("PRECISION"))
 TIMEMORY_SETTINGS_MEMBER_DEF(int16_t, width, TIMEMORY_SETTINGS_KEY("WIDTH"))
@@ -1301,14 +1428,34 @@ TIMEMORY_SETTINGS_MEMBER_DEF(uint64_t, dart_count, TIMEMORY_SETTINGS_KEY("DART_C
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, dart_label, TIMEMORY_SETTINGS_KEY("DART_LABEL"))
 TIMEMORY_SETTINGS_MEMBER_DEF(size_t, max_thread_bookmarks,
                              TIMEMORY_SETTINGS_KEY("MAX_THREAD_BOOKMARKS"))
+TIMEMORY_SETTINGS_MEMBER_DEF(bool, incremental_merge,
+                             TIMEMORY_SETTINGS_KEY("INCREMENTAL_MERGE"))
+TIMEMORY_SETTINGS_MEMBER_DEF(size_t, parallel_merge,
+                             TIMEMORY_SETTINGS_KEY("PARALLEL_MERGE"))
+TIMEMORY_SETTINGS_MEMBER_DEF(size_t, parallel_output,
+                             TIMEMORY_SETTINGS_KEY("PARALLEL_OUTPUT"))
+TIMEMORY_SETTINGS_MEMBER_DEF(size_t, node_limit, TIMEMORY_SETTINGS_KEY("NODE_LIMIT"))
+TIMEMORY_SETTINGS_MEMBER_DEF(size_t, thread_node_limit,
+                             TIMEMORY_SETTINGS_KEY("THREAD_NODE_LIMIT"))
+TIMEMORY_SETTINGS_MEMBER_DEF(double, collapse_threshold,
+                             TIMEMORY_SETTINGS_KEY("COLLAPSE_THRESHOLD"))
+TIMEMORY_SETTINGS_MEMBER_DEF(size_t, collapse_min_laps,
+                             TIMEMORY_SETTINGS_KEY("COLLAPSE_MIN_LAPS"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, cpu_affinity, TIMEMORY_SETTINGS_KEY("CPU_AFFINITY"))
 TIMEMORY_SETTINGS_MEMBER_DEF(bool, stack_clearing,
                              TIMEMORY_SETTINGS_KEY("STACK_CLEARING"))
-TIMEMORY_SETTINGS_MEMBER_DEF(bool, add_secondary, TIMEMORY_SETTINGS_KEY("ADD_SECONDARY"))
-TIMEMORY_SETTINGS_MEMBER_DEF(size_t, throttle_count,
-                             TIMEMORY_SETTINGS_KEY("THROTTLE_COUNT"))
-TIMEMORY_SETTINGS_MEMBER_DEF(size_t, throttle_value,
-                             TIMEMORY_SETTINGS_KEY("THROTTLE_VALUE"))
+TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(bool, add_secondary,
+                                    TIMEMORY_SETTINGS_KEY("ADD_SECONDARY"))
+TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(size_t, throttle_count,
+                                    TIMEMORY_SETTINGS_KEY("THROTTLE_COUNT"))
+TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(size_t, throttle_value,
+                                    TIMEMORY_SETTINGS_KEY("THROTTLE_VALUE"))
+TIMEMORY_SETTINGS_MEMBER_DEF(bool, adaptive_throttle,
+                             TIMEMORY_SETTINGS_KEY("ADAPTIVE_THROTTLE"))
+TIMEMORY_SETTINGS_MEMBER_DEF(double, throttle_budget,
+                             TIMEMORY_SETTINGS_KEY("THROTTLE_BUDGET"))
+TIMEMORY_SETTINGS_MEMBER_DEF(size_t, throttle_max_period,
+                             TIMEMORY_SETTINGS_KEY("THROTTLE_MAX_PERIOD"))
 TIMEMORY_SETTINGS_MEMBER_DEF(string_t, global_components,
                              TIMEMORY_SETTINGS_KEY("GLOBAL_COMPONENTS"))
 TIMEMORY_SETTINGS_MEMBER_DEF(string_t, tuple_components,
@@ -1406,8 +1553,8 @@ TIMEMORY_SETTINGS_MEMBER_DEF(string_t, ert_skip_ops,
 TIMEMORY_SETTINGS_MEMBER_DEF(string_t, craypat_categories,
                              TIMEMORY_SETTINGS_KEY("CRAYPAT"))
 TIMEMORY_SETTINGS_MEMBER_DEF(int32_t, node_count, TIMEMORY_SETTINGS_KEY("NODE_COUNT"))
-TIMEMORY_SETTINGS_MEMBER_DEF(bool, destructor_report,
-                             TIMEMORY_SETTINGS_KEY("DESTRUCTOR_REPORT"))
+TIMEMORY_SETTINGS_CACHED_MEMBER_DEF(bool, destructor_report,
+                                    TIMEMORY_SETTINGS_KEY("DESTRUCTOR_REPORT"))
 TIMEMORY_SETTINGS_MEMBER_DEF(string_t, python_exe, TIMEMORY_SETTINGS_KEY("PYTHON_EXE"))
 // stream
 TIMEMORY_SETTINGS_MEMBER_DEF(int64_t, separator_frequency,
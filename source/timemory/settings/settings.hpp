@@ -129,6 +129,7 @@ struct settings
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, plot_output)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, diff_output)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, flamegraph_output)
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, binary_output)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, ctest_notes)
     TIMEMORY_SETTINGS_MEMBER_DECL(int, verbose)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, debug)
@@ -136,6 +137,10 @@ struct settings
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, collapse_threads)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, collapse_processes)
     TIMEMORY_SETTINGS_MEMBER_DECL(uint16_t, max_depth)
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, event_trace)
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, event_trace_buffer_size)
+    TIMEMORY_SETTINGS_MEMBER_DECL(string_t, event_trace_overflow)
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, chrome_trace_output)
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, time_format)
     TIMEMORY_SETTINGS_MEMBER_DECL(int16_t, precision)
     TIMEMORY_SETTINGS_MEMBER_DECL(int16_t, width)
@@ -158,11 +163,21 @@ struct settings
     TIMEMORY_SETTINGS_MEMBER_DECL(uint64_t, dart_count)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, dart_label)
     TIMEMORY_SETTINGS_MEMBER_DECL(size_t, max_thread_bookmarks)
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, incremental_merge)
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, parallel_merge)
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, parallel_output)
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, node_limit)
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, thread_node_limit)
+    TIMEMORY_SETTINGS_MEMBER_DECL(double, collapse_threshold)
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, collapse_min_laps)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, cpu_affinity)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, stack_clearing)
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, add_secondary)
     TIMEMORY_SETTINGS_MEMBER_DECL(size_t, throttle_count)
     TIMEMORY_SETTINGS_MEMBER_DECL(size_t, throttle_value)
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, adaptive_throttle)
+    TIMEMORY_SETTINGS_MEMBER_DECL(double, throttle_budget)
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, throttle_max_period)
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, global_components)
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, tuple_components)
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, list_components)
@@ -356,6 +371,35 @@ protected:
     }
 
 private:
+    /// \struct tim::settings::hot_data
+    /// \brief Pointers to the values of the settings which are queried for every
+    /// measurement, packed into one cache-line. The accessors of these settings read
+    /// the value through the pointer instead of hashing the environment variable and
+    /// searching \ref m_data. The pointers reference the value stored in the entry of
+    /// \ref m_data so modifications through the returned reference, \ref parse,
+    /// \ref set or a configuration file are seen without any republishing. The
+    /// pointers are re-assigned when the entries are replaced (copy and assignment).
+    /// It is not over-aligned so settings is still allocated by make_shared in C++14.
+    struct hot_data
+    {
+        bool*     enabled           = nullptr;
+        bool*     debug             = nullptr;
+        int*      verbose           = nullptr;
+        uint16_t* max_depth         = nullptr;
+        bool*     add_secondary     = nullptr;
+        bool*     destructor_report = nullptr;
+        size_t*   throttle_count    = nullptr;
+        size_t*   throttle_value    = nullptr;
+    };
+
+    static_assert(sizeof(hot_data) <= 64, "hot settings exceed a cache-line");
+
+    template <typename Tp>
+    Tp*  get_value_pointer(const string_view_t&);
+    void update_hot_data();
+
+private:
+    hot_data    m_hot_data     = {};
     data_type   m_data         = {};
     strvector_t m_order        = {};
     strvector_t m_command_line = {};
@@ -473,6 +517,7 @@ settings::load(Archive& ar, unsigned int version)
             m_data.insert({ m_order.back(), itr.second });
         }
     }
+    update_hot_data();
     consume_parameters(version);
 }
 //
@@ -500,6 +545,26 @@ settings::save(Archive& ar, unsigned int) const
 //
 //----------------------------------------------------------------------------------//
 //
+template <typename Tp>
+Tp*
+settings::get_value_pointer(const string_view_t& _key)
+{
+    auto itr = m_data.find(_key);
+    if(itr != m_data.end() && itr->second)
+    {
+        auto _vptr = itr->second;
+        auto _tidx = std::type_index(typeid(Tp));
+        auto _vidx = std::type_index(typeid(Tp&));
+        if(_vptr->get_type_index() == _tidx && _vptr->get_value_index() == _tidx)
+            return &static_cast<tsettings<Tp, Tp>*>(_vptr.get())->get();
+        if(_vptr->get_type_index() == _tidx && _vptr->get_value_index() == _vidx)
+            return &static_cast<tsettings<Tp, Tp&>*>(_vptr.get())->get();
+    }
+    return nullptr;
+}
+//
+//----------------------------------------------------------------------------------//
+//
 template <typename Sp>
 inline auto
 settings::find(Sp&& _key, bool _exact)
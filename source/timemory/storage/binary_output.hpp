@@ -0,0 +1,426 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * \file timemory/storage/binary_output.hpp
+ * \brief Compact binary layout of the call-graph results of a component, the binary
+ * equivalent of the JSON output of \ref tim::operation::finalize::print
+ */
+
+#pragma once
+
+#include "timemory/storage/output_format.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+/// \namespace tim::binary_output
+/// \brief When TIMEMORY_BINARY_OUTPUT is enabled, the results of each component are
+/// also written to <OUTPUT_PATH>/<OUTPUT_PREFIX><label>.bin. Only the fields which are
+/// needed to reconstruct the call-graph are written and each node is a fixed-size
+/// \ref tim::binary_output::node_header, the characters of the prefix and the values
+/// of the component (get()) as doubles, so writing the file is a series of block copies
+/// instead of the formatting of text.
+///
+/// The layout of the file is:
+///   - \ref tim::binary_output::file_header
+///   - strings: label, description, display unit (uint32 length + characters)
+///   - int64: concurrency
+///   - for each rank: uint64 rank, uint64 number of nodes, then the nodes in pre-order
+///
+/// \ref tim::binary_output::reader reads the file in C++ and write_json converts it to
+/// JSON. The timemory.binary python module reads the same layout.
+namespace binary_output
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::binary_output::file_header
+/// \brief The header of the binary file. The endian tag is written in the byte order
+/// of the writer.
+struct file_header
+{
+    char     magic[8]   = { 'T', 'I', 'M', 'G', 'R', 'A', 'P', 'H' };
+    uint32_t version    = 1;
+    uint32_t endian     = 0x01020304;
+    uint32_t value_size = sizeof(double);
+    uint32_t nvalues    = 0;  ///< number of values of each node
+    uint64_t nranks     = 0;
+};
+//
+static_assert(sizeof(file_header) == 32, "binary_output::file_header should be 32 bytes");
+//
+/// \struct tim::binary_output::node_header
+/// \brief The fixed-size fields of a node. The characters of the prefix and the values
+/// follow the header.
+struct node_header
+{
+    uint64_t hash   = 0;
+    int64_t  depth  = 0;
+    uint64_t laps   = 0;
+    uint16_t tid    = 0;
+    uint16_t pid    = 0;
+    uint32_t length = 0;  ///< length of the prefix
+};
+//
+static_assert(sizeof(node_header) == 32, "binary_output::node_header should be 32 bytes");
+//
+/// \struct tim::binary_output::metadata
+/// \brief The description of the component
+struct metadata
+{
+    std::string label       = {};
+    std::string description = {};
+    std::string unit        = {};
+    int64_t     concurrency = 1;
+};
+//
+/// \struct tim::binary_output::node
+/// \brief A node of the call-graph as it is read, see \ref reader::read
+struct node : node_header
+{
+    uint64_t            rank   = 0;
+    std::string         prefix = {};
+    std::vector<double> values = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::binary_output::value_width
+/// \brief The number of doubles written for a value type: one for arithmetic types and
+/// N for a std::array of N arithmetic values. The binary output is not supported for
+/// other value types (zero)
+template <typename Tp>
+struct value_width
+: std::integral_constant<size_t, (std::is_arithmetic<Tp>::value) ? 1 : 0>
+{};
+//
+template <typename Tp, size_t N>
+struct value_width<std::array<Tp, N>>
+: std::integral_constant<size_t, (std::is_arithmetic<Tp>::value) ? N : 0>
+{};
+//
+template <typename Tp>
+void
+flatten(double* _out, const Tp& _v, std::true_type)
+{
+    _out[0] = static_cast<double>(_v);
+}
+//
+template <typename Tp, size_t N>
+void
+flatten(double* _out, const std::array<Tp, N>& _v, std::false_type)
+{
+    for(size_t i = 0; i < N; ++i)
+        _out[i] = static_cast<double>(_v[i]);
+}
+//
+/// writes the value_width<Tp> values of the value into the buffer
+template <typename Tp>
+void
+flatten(double* _out, const Tp& _v)
+{
+    flatten(_out, _v, std::is_arithmetic<Tp>{});
+}
+/// the display unit of components with a single value, empty otherwise
+using output_format::get_unit;
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::binary_output::writer
+/// \brief Writes the header and the metadata when it is constructed and then the ranks
+/// and their nodes in the order they are provided
+class writer
+{
+public:
+    writer(std::ostream& _os, const metadata& _meta, uint32_t _nvalues, uint64_t _nranks)
+    : m_os{ _os }
+    , m_nvalues{ _nvalues }
+    {
+        file_header _header{};
+        _header.nvalues = _nvalues;
+        _header.nranks  = _nranks;
+        write(&_header, sizeof(_header));
+        write_string(_meta.label);
+        write_string(_meta.description);
+        write_string(_meta.unit);
+        write(&_meta.concurrency, sizeof(_meta.concurrency));
+    }
+
+    void write_rank(uint64_t _rank, uint64_t _nnodes)
+    {
+        write(&_rank, sizeof(_rank));
+        write(&_nnodes, sizeof(_nnodes));
+    }
+
+    /// writes the node, the length of the header is set from the prefix and the values
+    /// should contain the number of values provided to the constructor
+    void write_node(node_header _header, const std::string& _prefix,
+                    const double* _values)
+    {
+        _header.length = static_cast<uint32_t>(_prefix.length());
+        write(&_header, sizeof(_header));
+        write(_prefix.data(), _prefix.length());
+        write(_values, m_nvalues * sizeof(double));
+    }
+
+private:
+    void write(const void* _data, size_t _n)
+    {
+        m_os.write(reinterpret_cast<const char*>(_data), _n);
+    }
+
+    void write_string(const std::string& _v)
+    {
+        auto _n = static_cast<uint32_t>(_v.length());
+        write(&_n, sizeof(_n));
+        write(_v.data(), _n);
+    }
+
+private:
+    std::ostream& m_os;
+    uint32_t      m_nvalues = 0;
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::binary_output::reader
+/// \brief Reads a file written by the \ref tim::binary_output::writer. The header and
+/// the metadata are read when the file is opened and the nodes are streamed by
+/// \ref read so the file is never held in memory.
+class reader
+{
+public:
+    explicit reader(std::string _filename)
+    : m_filename{ std::move(_filename) }
+    {
+        open();
+    }
+
+    bool               is_valid() const { return m_error.empty(); }
+    const std::string& get_error() const { return m_error; }
+    const std::string& get_filename() const { return m_filename; }
+    const file_header& get_header() const { return m_header; }
+    const metadata&    get_metadata() const { return m_metadata; }
+
+    /// invokes the function with each node in the order of the file and returns the
+    /// number of nodes. The node passed to the function is reused for the next node.
+    template <typename FuncT>
+    uint64_t read(FuncT&& _func)
+    {
+        if(!is_valid())
+            return 0;
+
+        std::ifstream _ifs{ m_filename, std::ios::in | std::ios::binary };
+        _ifs.seekg(m_offset);
+
+        uint64_t _n = 0;
+        node     _node{};
+        _node.values.resize(m_header.nvalues);
+        for(uint64_t i = 0; i < m_header.nranks; ++i)
+        {
+            uint64_t _nnodes = 0;
+            _ifs.read(reinterpret_cast<char*>(&_node.rank), sizeof(_node.rank));
+            _ifs.read(reinterpret_cast<char*>(&_nnodes), sizeof(_nnodes));
+            for(uint64_t j = 0; j < _nnodes; ++j)
+            {
+                _ifs.read(reinterpret_cast<char*>(static_cast<node_header*>(&_node)),
+                          sizeof(node_header));
+                if(!_ifs || _node.length > m_size)
+                    break;
+                _node.prefix.resize(_node.length);
+                _ifs.read(&_node.prefix[0], _node.length);
+                _ifs.read(reinterpret_cast<char*>(_node.values.data()),
+                          _node.values.size() * sizeof(double));
+                if(!_ifs)
+                    break;
+                _func(static_cast<const node&>(_node));
+                ++_n;
+            }
+            if(!_ifs)
+            {
+                m_error = "'" + m_filename + "' is truncated";
+                break;
+            }
+        }
+        return _n;
+    }
+
+private:
+    void open()
+    {
+        std::ifstream _ifs{ m_filename, std::ios::in | std::ios::binary };
+        if(!_ifs)
+        {
+            m_error = "unable to open '" + m_filename + "'";
+            return;
+        }
+        _ifs.seekg(0, std::ios::end);
+        m_size = _ifs.tellg();
+        _ifs.seekg(0, std::ios::beg);
+
+        file_header _ref{};
+        if(!_ifs.read(reinterpret_cast<char*>(&m_header), sizeof(m_header)) ||
+           !std::equal(std::begin(_ref.magic), std::end(_ref.magic), m_header.magic))
+            m_error = "'" + m_filename + "' is not a timemory binary output";
+        else if(m_header.endian != _ref.endian)
+            m_error = "'" + m_filename + "' was written with a different byte order";
+        else if(m_header.version != _ref.version)
+            m_error = "'" + m_filename + "' has an unsupported version (" +
+                      std::to_string(m_header.version) + ")";
+        else if(m_header.value_size != sizeof(double))
+            m_error = "'" + m_filename + "' is corrupted";
+        if(!is_valid())
+            return;
+
+        auto _read_string = [&_ifs, this]() {
+            uint32_t _n = 0;
+            _ifs.read(reinterpret_cast<char*>(&_n), sizeof(_n));
+            if(!_ifs || _n > m_size)
+            {
+                _ifs.setstate(std::ios::failbit);
+                return std::string{};
+            }
+            std::string _v(_n, '\0');
+            _ifs.read(&_v[0], _n);
+            return _v;
+        };
+
+        m_metadata.label       = _read_string();
+        m_metadata.description = _read_string();
+        m_metadata.unit        = _read_string();
+        _ifs.read(reinterpret_cast<char*>(&m_metadata.concurrency),
+                  sizeof(m_metadata.concurrency));
+        if(!_ifs)
+            m_error = "'" + m_filename + "' has a corrupted header";
+        m_offset = _ifs.tellg();
+    }
+
+private:
+    uint64_t    m_size     = 0;
+    uint64_t    m_offset   = 0;
+    std::string m_filename = {};
+    std::string m_error    = {};
+    file_header m_header   = {};
+    metadata    m_metadata = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// converts the binary output to JSON with the same hierarchy as the JSON output of
+/// the component: timemory -> <label> -> ranks -> graph. Each node has the hash,
+/// prefix, depth, tid, pid and an entry with the laps and the value(s) of the component
+/// (repr_data). The nodes are written as they are read. Returns the number of nodes
+inline uint64_t
+write_json(reader& _reader, std::ostream& _os)
+{
+    using output_format::escape;
+    using output_format::number;
+
+    if(!_reader.is_valid())
+        return 0;
+
+    const auto& _meta    = _reader.get_metadata();
+    auto        _nvalues = _reader.get_header().nvalues;
+
+    _os << "{\"timemory\":{\"" << escape(_meta.label)
+        << "\":{\"num_ranks\":" << _reader.get_header().nranks
+        << ",\"concurrency\":" << _meta.concurrency << ",\"type\":\""
+        << escape(_meta.label) << "\",\"description\":\"" << escape(_meta.description)
+        << "\",\"unit_repr\":\"" << escape(_meta.unit) << "\",\"ranks\":[";
+
+    bool     _first_rank = true;
+    bool     _first_node = true;
+    uint64_t _rank       = 0;
+    auto     _n          = _reader.read([&](const node& _node) {
+        if(_first_rank || _node.rank != _rank)
+        {
+            _os << ((_first_rank) ? "\n" : "\n]},\n") << "{\"rank\":" << _node.rank
+                << ",\"graph\":[";
+            _first_rank = false;
+            _first_node = true;
+            _rank       = _node.rank;
+        }
+        _os << ((_first_node) ? "\n" : ",\n") << "{\"hash\":" << _node.hash
+            << ",\"prefix\":\"" << escape(_node.prefix) << "\",\"depth\":" << _node.depth
+            << ",\"tid\":" << _node.tid << ",\"pid\":" << _node.pid
+            << ",\"entry\":{\"laps\":" << _node.laps << ",\"repr_data\":";
+        if(_nvalues == 1)
+        {
+            _os << number(_node.values.front());
+        }
+        else
+        {
+            _os << "[";
+            for(size_t i = 0; i < _node.values.size(); ++i)
+                _os << ((i == 0) ? "" : ",") << number(_node.values[i]);
+            _os << "]";
+        }
+        _os << "}}";
+        _first_node = false;
+    });
+
+    _os << ((_first_rank) ? "" : "\n]}") << "\n]}}}\n";
+    return _n;
+}
+//
+/// converts the binary output into JSON. When the output file is not provided, ".json"
+/// is appended to the name of the input file so that the JSON output of the component
+/// is not replaced. Returns the name of the output file or an empty string if there was
+/// an error
+inline std::string
+write_json(const std::string& _input, std::string _output = {})
+{
+    reader _reader{ _input };
+    if(!_reader.is_valid())
+    {
+        fprintf(stderr, "[binary_output]> Error: %s\n", _reader.get_error().c_str());
+        return std::string{};
+    }
+
+    if(_output.empty())
+        _output = _input + ".json";
+
+    std::ofstream _ofs{ _output };
+    if(!_ofs)
+    {
+        fprintf(stderr, "[binary_output]> Error opening '%s'\n", _output.c_str());
+        return std::string{};
+    }
+    write_json(_reader, _ofs);
+    return _output;
+}
+//
+}  // namespace binary_output
+}  // namespace tim
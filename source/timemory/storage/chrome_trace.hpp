@@ -0,0 +1,222 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * \file timemory/storage/chrome_trace.hpp
+ * \brief Conversion of the event trace into the Trace Event Format JSON which is
+ * viewed in chrome://tracing and the Perfetto UI
+ */
+
+#pragma once
+
+#include "timemory/settings/declaration.hpp"
+#include "timemory/storage/event_trace.hpp"
+#include "timemory/storage/output_format.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+namespace event_trace
+{
+namespace chrome_trace
+{
+//
+using output_format::escape;
+using output_format::number;
+//
+/// the nanosecond timestamp in microseconds, the time unit of the format
+inline std::string
+timestamp(int64_t _v)
+{
+    char _buff[32];
+    snprintf(_buff, sizeof(_buff), "%lld.%03lld", static_cast<long long>(_v / 1000),
+             static_cast<long long>(std::abs(_v % 1000)));
+    return _buff;
+}
+//
+/// the components of a bundle are pushed together and popped in the same order so
+/// each component of a thread is written on its own track, otherwise the end events
+/// would not be nested in the begin events of the viewer
+inline uint64_t
+track(const record& _v)
+{
+    return (static_cast<uint64_t>(_v.tid) << 16) | _v.type;
+}
+//
+}  // namespace chrome_trace
+//
+//--------------------------------------------------------------------------------------//
+//
+/// writes the records of the event trace as Trace Event Format JSON. Each record is
+/// written as a begin ("B") or end ("E") event as it is read so the memory use does
+/// not depend on the size of the trace. The events of each component of a thread are
+/// written on a separate track named "thread <tid> <component>". Components which are counters
+/// (e.g. page_rss) are also written as a counter ("C") track of the process. Returns
+/// the number of records
+inline uint64_t
+write_chrome_trace(reader& _reader, std::ostream& _os)
+{
+    using namespace chrome_trace;
+
+    if(!_reader.is_valid())
+        return 0;
+
+    const auto& _types = _reader.get_types();
+    const auto  _pid   = std::to_string(_reader.get_header().pid);
+
+    std::vector<std::string> _categories{};
+    std::vector<std::string> _series{};
+    for(const auto& itr : _types)
+    {
+        _categories.emplace_back(escape(itr.label));
+        _series.emplace_back(escape(itr.unit.empty() ? itr.label : itr.unit));
+    }
+
+    // the labels are escaped once
+    std::unordered_map<uint64_t, std::string> _names{};
+    auto _get_name = [&_reader, &_names](uint64_t _hash) -> const std::string& {
+        auto itr = _names.find(_hash);
+        if(itr == _names.end())
+            itr = _names.emplace(_hash, escape(_reader.get_label(_hash))).first;
+        return itr->second;
+    };
+
+    bool _first = true;
+    auto _begin = [&_os, &_first]() -> std::ostream& {
+        _os << ((_first) ? "\n" : ",\n");
+        _first = false;
+        return _os;
+    };
+
+    _os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    _begin() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << _pid
+             << ",\"tid\":0,\"args\":{\"name\":\"process " << _pid << "\"}}";
+
+    // the value of the counters at the begin event of each thread
+    std::unordered_set<uint64_t>                                 _tracks{};
+    std::map<std::pair<uint32_t, uint16_t>, std::vector<double>> _counters{};
+
+    auto _counter = [&](const record& _v, double _value) {
+        _begin() << "{\"name\":\"" << _categories.at(_v.type)
+                 << "\",\"ph\":\"C\",\"ts\":" << timestamp(_v.timestamp)
+                 << ",\"pid\":" << _pid << ",\"args\":{\"" << _series.at(_v.type)
+                 << "\":" << number(_value) << "}}";
+    };
+
+    auto _n = _reader.read([&](const record& _v) {
+        if(_v.type >= _types.size())
+            return;
+
+        auto _track = track(_v);
+        if(_tracks.insert(_track).second)
+        {
+            _begin() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << _pid
+                     << ",\"tid\":" << _track << ",\"args\":{\"name\":\"thread "
+                     << _v.tid << " " << _categories.at(_v.type) << "\"}}";
+        }
+
+        bool _is_begin = (_v.phase == static_cast<uint8_t>(phase::begin));
+        _begin() << "{\"name\":\"" << _get_name(_v.hash) << "\",\"cat\":\""
+                 << _categories.at(_v.type) << "\",\"ph\":\""
+                 << ((_is_begin) ? "B" : "E") << "\",\"ts\":" << timestamp(_v.timestamp)
+                 << ",\"pid\":" << _pid << ",\"tid\":" << _track;
+        if(!_is_begin)
+            _os << ",\"args\":{\"" << _series.at(_v.type) << "\":" << number(_v.value)
+                << "}";
+        _os << "}";
+
+        if(!_types.at(_v.type).counter)
+            return;
+
+        // the value at the end is the value at the begin plus the difference
+        auto& _stack = _counters[{ _v.tid, _v.type }];
+        if(_is_begin)
+        {
+            _stack.emplace_back(_v.value);
+            _counter(_v, _v.value);
+        }
+        else if(!_stack.empty())
+        {
+            _counter(_v, _stack.back() + _v.value);
+            _stack.pop_back();
+        }
+    });
+
+    _os << "\n],\"otherData\":{\"events\":" << _n
+        << ",\"dropped\":" << _reader.get_dropped()
+        << ",\"overwritten\":" << _reader.get_overwritten() << "}}\n";
+    return _n;
+}
+//
+/// converts the binary event trace into Trace Event Format JSON. When the output file
+/// is not provided, the extension of the input file is replaced with ".json". Returns
+/// the name of the output file or an empty string if there was an error
+inline std::string
+write_chrome_trace(const std::string& _input, std::string _output = {})
+{
+    if(_input.empty())
+        return std::string{};
+
+    reader _reader{ _input };
+    if(!_reader.is_valid())
+    {
+        fprintf(stderr, "[event_trace]> Error: %s\n", _reader.get_error().c_str());
+        return std::string{};
+    }
+
+    if(_output.empty())
+    {
+        auto _pos = _input.find_last_of('.');
+        _output   = ((_pos != std::string::npos && _input.substr(_pos) == ".bin")
+                       ? _input.substr(0, _pos)
+                       : _input) +
+                  ".json";
+    }
+
+    std::ofstream _ofs{ _output };
+    if(!_ofs)
+    {
+        fprintf(stderr, "[event_trace]> Error opening '%s'\n", _output.c_str());
+        return std::string{};
+    }
+
+    if(settings::verbose() >= 0)
+        fprintf(stderr, "[event_trace]> Outputting '%s'...\n", _output.c_str());
+    write_chrome_trace(_reader, _ofs);
+    return _output;
+}
+//
+}  // namespace event_trace
+}  // namespace tim
@@ -43,20 +43,26 @@
 #include "timemory/storage/graph_data.hpp"
 #include "timemory/storage/macros.hpp"
 #include "timemory/storage/node.hpp"
+#include "timemory/storage/node_index.hpp"
+#include "timemory/storage/snapshot.hpp"
 #include "timemory/storage/types.hpp"
+#include "timemory/storage/usage.hpp"
 #include "timemory/tpls/cereal/cereal.hpp"
 #include "timemory/utility/macros.hpp"
 #include "timemory/utility/singleton.hpp"
 #include "timemory/utility/types.hpp"
 #include "timemory/utility/utility.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace tim
 {
@@ -121,6 +127,7 @@ public:
     using result_array_t = std::vector<result_node>;
     using dmp_result_t   = std::vector<result_array_t>;
     using printer_t      = operation::finalize::print<Type, has_data_v>;
+    using output_task_t  = manager::output_task_t;
     using sample_array_t = std::vector<Type>;
     using graph_node_t   = graph_node;
     using graph_data_t   = graph_data<graph_node_t>;
@@ -130,9 +137,12 @@ public:
     using const_iterator = typename graph_type::const_iterator;
 
     template <typename Vp>
-    using secondary_data_t       = std::tuple<iterator, const std::string&, Vp>;
-    using iterator_hash_submap_t = uomap_t<int64_t, iterator>;
-    using iterator_hash_map_t    = uomap_t<int64_t, iterator_hash_submap_t>;
+    using secondary_data_t    = std::tuple<iterator, const std::string&, Vp>;
+    using iterator_hash_map_t = node_index<iterator>;
+    /// the "[collapsed]" child of a node and the ids of its children which were
+    /// collapsed into it
+    using collapse_entry_t = std::pair<iterator, std::vector<uint64_t>>;
+    using collapse_map_t   = std::unordered_map<const graph_node_t*, collapse_entry_t>;
 
     friend class tim::manager;
     friend struct node::result<Type>;
@@ -159,6 +169,7 @@ public:
 private:
     static singleton_t* get_singleton() { return get_storage_singleton<this_type>(); }
     static std::atomic<int64_t>& instance_count();
+    static std::atomic<int64_t>& node_budget_count();
 
 public:
 public:
@@ -227,7 +238,87 @@ public:
 
     iterator_hash_map_t get_node_ids() const { return m_node_ids; }
 
-    void stack_push(Type* obj) { m_stack.insert(obj); }
+    /// struct-of-arrays copy of the call-graph of this thread which may be taken from
+    /// another thread while this thread continues to insert. New nodes are not
+    /// inserted while the graph is copied so the topology is consistent but each value
+    /// is the value at the time the node was copied
+    template <typename Up = Type,
+              enable_if_t<concepts::is_snapshot_value<typename Up::value_type>::value,
+                          int> = 0>
+    storage_snapshot<Up> snapshot() const
+    {
+        storage_snapshot<Up> _ret{};
+        if(m_graph_data_instance)
+        {
+            m_graph_data_instance->read(
+                [&_ret](const graph_t& _graph) { _ret.assign(_graph); });
+        }
+        return _ret;
+    }
+
+    /// snapshot of the master thread followed by the snapshot of every worker thread.
+    /// Workers which exit during the snapshots wait until they are complete
+    template <typename Up = Type,
+              enable_if_t<concepts::is_snapshot_value<typename Up::value_type>::value,
+                          int> = 0>
+    std::vector<storage_snapshot<Up>> snapshots() const
+    {
+        std::vector<storage_snapshot<Up>> _ret{};
+        auto_lock_t _lk{ singleton_t::get_mutex() };
+        auto*       _master = singleton_t::master_instance_ptr();
+        if(!_master)
+            return _ret;
+        auto _children = singleton_t::children();
+        _ret.reserve(_children.size() + 1);
+        _ret.emplace_back(_master->template snapshot<Up>());
+        for(auto* itr : _children)
+        {
+            if(itr && itr != _master)
+                _ret.emplace_back(itr->template snapshot<Up>());
+        }
+        return _ret;
+    }
+
+    /// heap bytes held by the storage of this thread as of the last modification of
+    /// the storage by this thread. It may be called from any thread
+    storage_usage usage();
+
+    /// usage of the master thread followed by the usage of every worker thread
+    static std::vector<storage_usage> usages();
+
+    /// number of tree insertions resolved by the child hint of the current node
+    uint64_t child_hint_hits() const { return m_child_hint_hits; }
+    /// number of tree insertions which required a hash-table lookup or child search
+    uint64_t child_hint_misses() const { return m_child_hint_misses; }
+    /// number of nodes created by insertions on this thread
+    uint64_t node_count() const { return m_node_count; }
+    /// number of insertions folded into an "[other]" node because of the node limits
+    uint64_t folded_inserts() const { return m_folded_inserts; }
+    /// number of insertions combined into a "[collapsed]" node or skipped beneath one
+    uint64_t collapsed_inserts() const { return m_collapsed_inserts; }
+    /// number of nodes which were folded into the "[collapsed]" child of their parent
+    size_t collapsed_count() const
+    {
+        size_t _n = 0;
+        for(const auto& itr : m_collapsed)
+            _n += itr.second.second.size();
+        return _n;
+    }
+    /// pops a call which was not inserted because it is beneath a collapsed call,
+    /// returns false if there is no such call
+    bool pop_collapsed()
+    {
+        if(m_collapse_depth < 2)
+            return false;
+        --m_collapse_depth;
+        return true;
+    }
+
+    void stack_push(Type* obj)
+    {
+        m_stack.insert(obj);
+        storage_usage_counters::store(m_usage.stack, storage_usage::get_bytes(m_stack));
+    }
     void stack_pop(Type* obj);
 
     void insert_init();
@@ -245,7 +336,12 @@ public:
     template <typename Archive>
     void serialize(Archive& ar, unsigned int version);
 
-    void add_sample(Type&& _obj) { m_samples.emplace_back(std::forward<Type>(_obj)); }
+    void add_sample(Type&& _obj)
+    {
+        m_samples.emplace_back(std::forward<Type>(_obj));
+        storage_usage_counters::store(m_usage.samples,
+                                      m_samples.capacity() * sizeof(Type));
+    }
 
     auto&       get_samples() { return m_samples; }
     const auto& get_samples() const { return m_samples; }
@@ -256,9 +352,31 @@ protected:
     iterator insert_flat(uint64_t hash_id, const Type& obj, uint64_t hash_depth);
     iterator insert_hierarchy(uint64_t hash_id, const Type& obj, uint64_t hash_depth,
                               bool has_head);
+    iterator insert_other(iterator _parent, const Type& obj, uint64_t hash_depth);
+    bool     node_budget_exceeded() const;
+    void     node_budget_add();
+    iterator insert_collapsed(uint64_t hash_id);
+    void     update_collapse(iterator _itr);
+    void     reset_cursors();
+    void     update_usage();
+
+    template <typename Up>
+    static auto get_collapse_cost(const Up& _obj, int)
+        -> decltype(static_cast<double>(_obj.get()))
+    {
+        return static_cast<double>(_obj.get());
+    }
+
+    template <typename Up>
+    static double get_collapse_cost(const Up&, long)
+    {
+        return -1.0;
+    }
 
     void     merge();
     void     merge(this_type* itr);
+    void     retire(this_type* itr);
+    void     merge_retired();
     string_t get_prefix(const graph_node&);
     string_t get_prefix(iterator _node) { return get_prefix(*_node); }
     string_t get_prefix(const uint64_t& _id);
@@ -269,7 +387,12 @@ private:
     template <typename Archive>
     void do_serialize(Archive& ar);
 
-    void internal_print();
+    template <typename Archive>
+    void serialize_ranks(Archive& ar);
+
+    void          internal_print();
+    bool          internal_printer();
+    output_task_t internal_output();
 
     graph_data_t&       _data();
     const graph_data_t& _data() const
@@ -280,11 +403,25 @@ private:
 
 private:
     uint64_t                   m_timeline_counter    = 1;
+    uint64_t                   m_child_hint_hits     = 0;
+    uint64_t                   m_child_hint_misses   = 0;
+    uint64_t                   m_node_count          = 0;
+    uint64_t                   m_folded_inserts      = 0;
+    uint64_t                   m_collapsed_inserts   = 0;
+    int64_t                    m_collapse_depth      = 0;
+    const double*              m_collapse_threshold  = nullptr;
     mutable graph_data_t*      m_graph_data_instance = nullptr;
+    iterator                   m_flat_current        = nullptr;
     iterator_hash_map_t        m_node_ids;
     std::unordered_set<Type*>  m_stack;
     std::shared_ptr<printer_t> m_printer;
     sample_array_t             m_samples;
+    std::unique_ptr<graph_t>   m_retired;
+    std::mutex                 m_retired_mutex;
+    collapse_map_t             m_collapsed;
+    uint64_t                   m_collapsed_bytes = 0;
+    storage_usage_counters     m_usage;
+    bool                       m_output_written = false;
 };
 //
 //--------------------------------------------------------------------------------------//
@@ -296,23 +433,14 @@ storage<Type, true>::reset()
     // have the data graph erase all children of the head node
     if(m_graph_data_instance)
         m_graph_data_instance->reset();
-    // erase all the cached iterators except for m_node_ids[0][0]
-    for(auto& ditr : m_node_ids)
-    {
-        auto _depth = ditr.first;
-        if(_depth != 0)
-        {
-            ditr.second.clear();
-        }
-        else
-        {
-            for(auto itr = ditr.second.begin(); itr != ditr.second.end(); ++itr)
-            {
-                if(itr->first != 0)
-                    ditr.second.erase(itr);
-            }
-        }
-    }
+    // the erased nodes no longer count against the node limits
+    node_budget_count() -= static_cast<int64_t>(m_node_count);
+    m_node_count = 0;
+    // the flat and collapsed insertion points were descendants of the head node
+    reset_cursors();
+    // erase all the cached iterators except for the (0, 0) entry
+    m_node_ids.erase_if(
+        [](int64_t _depth, int64_t _hash, iterator) { return _depth != 0 || _hash != 0; });
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -335,6 +463,16 @@ storage<Type, true>::insert(scope::config scope_data, const Type& obj, uint64_t
        _data().dummy_count() < m_settings->get_max_thread_bookmarks())
         _data().add_dummy();
 
+    // calls beneath a collapsed call are included in the value of the outermost
+    // collapsed call so they are not inserted and do not hash or look up anything
+    bool _is_tree = !(scope_data.is_flat() || force_flat_t::value);
+    if(_is_tree && m_collapse_depth > 0)
+    {
+        ++m_collapse_depth;
+        ++m_collapsed_inserts;
+        return nullptr;
+    }
+
     // compute the insertion depth
     auto hash_depth = scope_data.compute_depth<force_tree_t, force_flat_t, force_time_t>(
         _data().depth());
@@ -343,23 +481,42 @@ storage<Type, true>::insert(scope::config scope_data, const Type& obj, uint64_t
     auto hash_value = scope_data.compute_hash<force_tree_t, force_flat_t, force_time_t>(
         hash_id, hash_depth, m_timeline_counter);
 
-    // alias the true id with the insertion key
-    add_hash_id(hash_id, hash_value);
+    auto _node_count = m_node_count;
+
+    // calls of a collapsed node are combined into the "[collapsed]" child of its parent
+    if(_is_tree && !m_collapsed.empty())
+    {
+        auto _itr = insert_collapsed(hash_value);
+        if(_itr)
+        {
+            if(m_node_count != _node_count)
+                update_usage();
+            return _itr;
+        }
+    }
 
     // even when flat is combined with timeline, it still inserts at depth of 1
     // so this is easiest check
-    if(scope_data.is_flat() || force_flat_t::value)
-        return insert_flat(hash_value, obj, hash_depth);
-
     // in the case of tree + timeline, timeline will have appropriately modified the
     // depth and hash so it doesn't really matter which check happens first here
     // however, the query for is_timeline() is cheaper so we will check that
     // and fallback to inserting into tree without a check
     // if(scope_data.is_timeline())
     //    return insert_timeline(hash_value, obj, hash_depth);
+    auto _itr = (scope_data.is_flat() || force_flat_t::value)
+                    ? insert_flat(hash_value, obj, hash_depth)
+                    : insert_tree(hash_value, obj, hash_depth);
+
+    // alias the true id with the insertion key when a node was created. The alias
+    // table is shared by all threads and the key of an existing node was aliased
+    // when the node was created so repeated calls skip the lookup
+    if(m_node_count != _node_count)
+    {
+        add_hash_id(hash_id, hash_value);
+        update_usage();
+    }
 
-    // default fall-through if neither flat nor timeline
-    return insert_tree(hash_value, obj, hash_depth);
+    return _itr;
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -377,26 +534,33 @@ storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
         return nullptr;
 
     // compute hash of prefix
-    auto _hash_id = add_hash_id(std::get<1>(_secondary));
+    auto _hash_id = get_hash_id(std::get<1>(_secondary));
     // compute hash w.r.t. parent iterator (so identical kernels from different
     // call-graph parents do not locate same iterator)
     auto _hash = _hash_id ^ _itr->id();
-    // add the hash alias
-    add_hash_id(_hash_id, _hash);
     // compute depth
     auto _depth = _itr->depth() + 1;
 
     // see if depth + hash entry exists already
-    auto _nitr = m_node_ids[_depth].find(_hash);
-    if(_nitr != m_node_ids[_depth].end())
+    auto* _nitr = m_node_ids.find(_depth, _hash);
+
+    // past the node limits the value is added to the "[other]" node of the parent
+    iterator _other = nullptr;
+    if(!_nitr && node_budget_exceeded())
+    {
+        _other = insert_other(_itr, Type{}, _depth);
+        _nitr  = &_other;
+    }
+
+    if(_nitr)
     {
         // if so, then update
-        auto& _obj = _nitr->second->obj();
+        auto& _obj = (*_nitr)->obj();
         _obj += std::get<2>(_secondary);
-        _obj.set_laps(_nitr->second->obj().get_laps() + 1);
-        auto& _stats = _nitr->second->stats();
-        operation::add_statistics<Type>(_nitr->second->obj(), _stats);
-        return _nitr->second;
+        _obj.set_laps(_obj.get_laps() + 1);
+        auto& _stats = (*_nitr)->stats();
+        operation::add_statistics<Type>(_obj, _stats);
+        return *_nitr;
     }
 
     // else, create a new entry
@@ -409,7 +573,12 @@ storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
     operation::add_statistics<Type>(_tmp, _stats);
     auto itr = _data().emplace_child(_itr, _node);
     itr->obj().set_iterator(itr);
-    m_node_ids[_depth][_hash] = itr;
+    m_node_ids.insert(_depth, _hash, itr);
+    node_budget_add();
+    update_usage();
+    // register the prefix and the hash alias only once per node
+    add_hash_id(std::get<1>(_secondary));
+    add_hash_id(_hash_id, _hash);
     return itr;
 }
 //
@@ -428,21 +597,28 @@ storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
         return nullptr;
 
     // compute hash of prefix
-    auto _hash_id = add_hash_id(std::get<1>(_secondary));
+    auto _hash_id = get_hash_id(std::get<1>(_secondary));
     // compute hash w.r.t. parent iterator (so identical kernels from different
     // call-graph parents do not locate same iterator)
     auto _hash = _hash_id ^ _itr->id();
-    // add the hash alias
-    add_hash_id(_hash_id, _hash);
     // compute depth
     auto _depth = _itr->depth() + 1;
 
     // see if depth + hash entry exists already
-    auto _nitr = m_node_ids[_depth].find(_hash);
-    if(_nitr != m_node_ids[_depth].end())
+    auto* _nitr = m_node_ids.find(_depth, _hash);
+
+    // past the node limits the value is added to the "[other]" node of the parent
+    iterator _other = nullptr;
+    if(!_nitr && node_budget_exceeded())
     {
-        _nitr->second->obj() += std::get<2>(_secondary);
-        return _nitr->second;
+        _other = insert_other(_itr, Type{}, _depth);
+        _nitr  = &_other;
+    }
+
+    if(_nitr)
+    {
+        (*_nitr)->obj() += std::get<2>(_secondary);
+        return *_nitr;
     }
 
     // else, create a new entry
@@ -450,7 +626,12 @@ storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
     graph_node_t _node(_hash, _tmp, _depth, m_thread_idx);
     auto         itr = _data().emplace_child(_itr, _node);
     itr->obj().set_iterator(itr);
-    m_node_ids[_depth][_hash] = itr;
+    m_node_ids.insert(_depth, _hash, itr);
+    node_budget_add();
+    update_usage();
+    // register the prefix and the hash alias only once per node
+    add_hash_id(std::get<1>(_secondary));
+    add_hash_id(_hash_id, _hash);
     return itr;
 }
 //
@@ -485,11 +666,12 @@ typename storage<Type, true>::iterator
 storage<Type, true>::insert_flat(uint64_t hash_id, const Type& obj, uint64_t hash_depth)
 {
     // PRINT_HERE("%s", "");
-    static thread_local auto _current = _data().head();
-    static thread_local bool _first   = true;
-    if(_first)
+    // flat entries are children of the first child of the head node. This is reset
+    // in reset() since erasing the graph returns that node to the allocator
+    auto& _current = m_flat_current;
+    if(!_current)
     {
-        _first = false;
+        _current = _data().head();
         if(_current.begin())
         {
             _current = _current.begin();
@@ -497,20 +679,25 @@ storage<Type, true>::insert_flat(uint64_t hash_id, const Type& obj, uint64_t has
         else
         {
             graph_node_t node(hash_id, obj, hash_depth, m_thread_idx);
-            auto         itr                = _data().emplace_child(_current, node);
-            m_node_ids[hash_depth][hash_id] = itr;
-            _current                        = itr;
+            auto         itr = _data().emplace_child(_current, node);
+            m_node_ids.insert(hash_depth, hash_id, itr);
+            node_budget_add();
+            _current = itr;
             return itr;
         }
     }
 
-    auto _existing = m_node_ids[hash_depth].find(hash_id);
-    if(_existing != m_node_ids[hash_depth].end())
-        return m_node_ids[hash_depth].find(hash_id)->second;
+    auto* _existing = m_node_ids.find(hash_depth, hash_id);
+    if(_existing)
+        return *_existing;
+
+    if(node_budget_exceeded())
+        return insert_other(_current, obj, hash_depth);
 
     graph_node_t node(hash_id, obj, hash_depth, m_thread_idx);
-    auto         itr                = _data().emplace_child(_current, node);
-    m_node_ids[hash_depth][hash_id] = itr;
+    auto         itr = _data().emplace_child(_current, node);
+    m_node_ids.insert(hash_depth, hash_id, itr);
+    node_budget_add();
     return itr;
 }
 //
@@ -521,7 +708,6 @@ typename storage<Type, true>::iterator
 storage<Type, true>::insert_hierarchy(uint64_t hash_id, const Type& obj,
                                       uint64_t hash_depth, bool has_head)
 {
-    using id_hash_map_t = typename iterator_hash_map_t::mapped_type;
     // PRINT_HERE("%s", "");
 
     auto& m_data = m_graph_data_instance;
@@ -531,41 +717,49 @@ storage<Type, true>::insert_hierarchy(uint64_t hash_id, const Type& obj,
     if(!has_head || (m_is_master && m_node_ids.empty()))
     {
         graph_node_t node(hash_id, obj, hash_depth, tid);
-        auto         itr                = m_data->append_child(node);
-        m_node_ids[hash_depth][hash_id] = itr;
-        return itr;
+        node_budget_add();
+        return m_node_ids.insert(hash_depth, hash_id, m_data->append_child(node));
     }
 
     // lambda for updating settings
     auto _update = [&](iterator itr) {
+        graph_t::set_child_hint(graph_t::parent(itr), itr);
         m_data->depth() = itr->depth();
         return (m_data->current() = itr);
     };
 
-    if(m_node_ids[hash_depth].find(hash_id) != m_node_ids[hash_depth].end() &&
-       m_node_ids[hash_depth].find(hash_id)->second->depth() == m_data->depth())
+    auto current = m_data->current();
+
+    // the most common case is re-entering the child of the current node which was
+    // entered last so check that before doing any hash-table lookups
+    auto _hint = graph_t::child_hint(current);
+    if(_hint && _hint->id() == hash_id)
     {
-        return _update(m_node_ids[hash_depth].find(hash_id)->second);
+        ++m_child_hint_hits;
+        m_data->depth() = _hint->depth();
+        return (m_data->current() = _hint);
     }
+    ++m_child_hint_misses;
+
+    auto* _existing = m_node_ids.find(hash_depth, hash_id);
+    if(_existing && (*_existing)->depth() == m_data->depth())
+        return _update(*_existing);
 
     using sibling_itr = typename graph_t::sibling_iterator;
     graph_node_t node(hash_id, obj, m_data->depth(), tid);
 
     // lambda for inserting child
     auto _insert_child = [&]() {
+        // past the node limits the child is folded into the "[other]" node of current
+        if(node_budget_exceeded())
+            return _update(insert_other(current, obj, hash_depth));
         node.depth() = hash_depth;
         auto itr     = m_data->append_child(node);
-        auto ditr    = m_node_ids.find(hash_depth);
-        if(ditr == m_node_ids.end())
-            m_node_ids.insert({ hash_depth, id_hash_map_t{} });
-        auto hitr = m_node_ids.at(hash_depth).find(hash_id);
-        if(hitr == m_node_ids.at(hash_depth).end())
-            m_node_ids.at(hash_depth).insert({ hash_id, iterator{} });
-        m_node_ids.at(hash_depth).at(hash_id) = itr;
-        return itr;
+        graph_t::set_child_hint(current, itr);
+        node_budget_add();
+        return m_node_ids.insert(hash_depth, hash_id, itr);
     };
 
-    auto current = m_data->current();
     if(!m_data->graph().is_valid(current))
         _insert_child();
 
@@ -600,6 +794,152 @@ storage<Type, true>::insert_hierarchy(uint64_t hash_id, const Type& obj,
 
     return _insert_child();
 }
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename Type>
+typename storage<Type, true>::iterator
+storage<Type, true>::insert_other(iterator _parent, const Type& obj, uint64_t hash_depth)
+{
+    using sibling_itr = typename graph_t::sibling_iterator;
+
+    ++m_folded_inserts;
+
+    static thread_local auto _hash_id = add_hash_id("[other]");
+
+    for(sibling_itr itr = _parent.begin(); itr != _parent.end(); ++itr)
+    {
+        if(itr->id() == _hash_id)
+            return itr;
+    }
+
+    // the "[other]" nodes are allowed to exceed the limits, at most one per parent
+    graph_node_t _node(_hash_id, obj, hash_depth, m_thread_idx);
+    auto         itr = _data().emplace_child(_parent, _node);
+    node_budget_add();
+    return itr;
+}
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename Type>
+typename storage<Type, true>::iterator
+storage<Type, true>::insert_collapsed(uint64_t hash_id)
+{
+    auto _current = _data().current();
+    auto _itr     = m_collapsed.find(&(*_current));
+    if(_itr == m_collapsed.end())
+        return nullptr;
+
+    auto& _ids = _itr->second.second;
+    if(std::find(_ids.begin(), _ids.end(), hash_id) == _ids.end())
+        return nullptr;
+
+    // the "[collapsed]" node is created by the first call which is combined into it
+    auto& _sink = _itr->second.first;
+    if(!_sink)
+    {
+        static thread_local auto _hash_id = add_hash_id("[collapsed]");
+        graph_node_t _node(_hash_id, Type{}, _data().depth() + 1, m_thread_idx);
+        _sink = _data().emplace_child(_current, _node);
+        node_budget_add();
+    }
+
+    // the current node does not change so the pop of this call and the calls
+    // beneath it only decrement the collapse depth
+    ++m_collapse_depth;
+    ++m_collapsed_inserts;
+    return _sink;
+}
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename Type>
+void
+storage<Type, true>::update_collapse(iterator _itr)
+{
+    if(!_itr || _itr->is_dummy() || _data().graph().is_head(_itr))
+        return;
+
+    // only re-evaluated every collapse_min_laps calls
+    auto _min_laps = std::max<int64_t>(m_settings->get_collapse_min_laps(), 1);
+    auto _laps     = static_cast<int64_t>(_itr->obj().get_laps());
+    if(_laps < _min_laps || (_laps % _min_laps) != 0)
+        return;
+
+    auto _cost = get_collapse_cost(_itr->obj(), 0);
+    if(_cost < 0.0 || _cost / _laps > *m_collapse_threshold)
+        return;
+
+    // the node is folded into its parent, i.e. its later calls are combined into the
+    // "[collapsed]" child of the parent
+    auto _parent = graph_t::parent(_itr);
+    if(!_parent || _parent->is_dummy() || _data().graph().is_head(_parent))
+        return;
+
+    auto& _ids = m_collapsed[&(*_parent)].second;
+    if(std::find(_ids.begin(), _ids.end(), _itr->id()) != _ids.end())
+        return;
+    _ids.emplace_back(_itr->id());
+
+    m_collapsed_bytes = storage_usage::get_bytes(m_collapsed);
+    for(const auto& itr : m_collapsed)
+        m_collapsed_bytes += storage_usage::get_bytes(itr.second.second);
+    update_usage();
+}
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename Type>
+void
+storage<Type, true>::reset_cursors()
+{
+    m_flat_current    = nullptr;
+    m_collapse_depth  = 0;
+    m_collapsed_bytes = 0;
+    m_collapsed.clear();
+    update_usage();
+}
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename Type>
+void
+storage<Type, true>::update_usage()
+{
+    uint64_t _graph = 0;
+    if(m_graph_data_instance)
+    {
+        _graph = sizeof(graph_data_t) +
+                 m_graph_data_instance->graph().get_allocator().alloc_bytes();
+    }
+    storage_usage_counters::store(m_usage.graph, _graph);
+    storage_usage_counters::store(m_usage.node_ids, m_node_ids.bytes() + m_collapsed_bytes);
+}
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename Type>
+bool
+storage<Type, true>::node_budget_exceeded() const
+{
+    auto _thread_limit = m_settings->get_thread_node_limit();
+    if(_thread_limit > 0 && m_node_count >= _thread_limit)
+        return true;
+    auto _limit = m_settings->get_node_limit();
+    return (_limit > 0 && node_budget_count().load(std::memory_order_relaxed) >=
+                              static_cast<int64_t>(_limit));
+}
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename Type>
+void
+storage<Type, true>::node_budget_add()
+{
+    ++m_node_count;
+    node_budget_count().fetch_add(1, std::memory_order_relaxed);
+}
 
 //
 //--------------------------------------------------------------------------------------//
@@ -609,28 +949,54 @@ template <typename Archive>
 void
 storage<Type, true>::serialize(Archive& ar, const unsigned int version)
 {
-    auto   num_instances = instance_count().load();
-    auto&& _results      = dmp_get();
+    auto num_instances = instance_count().load();
     ar(cereal::make_nvp("concurrency", num_instances));
     m_printer->print_metadata(ar, Type{});
     operation::extra_serialization<Type>{ ar };
+    serialize_ranks(ar);
+    consume_parameters(version);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+template <typename Archive>
+void
+storage<Type, true>::serialize_ranks(Archive& ar)
+{
+    using get_type = operation::finalize::get<Type, true>;
+
     ar.setNextName("ranks");
     ar.startNode();
     ar.makeArray();
-    for(uint64_t i = 0; i < _results.size(); ++i)
+    if(dmp::size() <= 1)
     {
-        if(_results.at(i).empty())
-            continue;
+        // a single process does not need the copy of the graph from dmp_get
+        if(!empty())
+        {
+            ar.startNode();
+            ar(cereal::make_nvp("rank", uint64_t{ 0 }));
+            get_type{ *this }(ar, typename get_type::streaming{});
+            ar.finishNode();
+        }
+    }
+    else
+    {
+        auto&& _results = dmp_get();
+        for(uint64_t i = 0; i < _results.size(); ++i)
+        {
+            if(_results.at(i).empty())
+                continue;
 
-        ar.startNode();
+            ar.startNode();
 
-        ar(cereal::make_nvp("rank", i));
-        save(ar, _results.at(i));
+            ar(cereal::make_nvp("rank", i));
+            save(ar, _results.at(i));
 
-        ar.finishNode();
+            ar.finishNode();
+        }
     }
     ar.finishNode();  // ranks
-    consume_parameters(version);
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -643,29 +1009,13 @@ storage<Type, true>::do_serialize(Archive& ar)
     if(m_is_master)
         merge();
 
-    auto   num_instances = instance_count().load();
-    auto&& _results      = dmp_get();
+    auto num_instances = instance_count().load();
     ar.setNextName(component::properties<Type>::id());
     ar.startNode();
     ar(cereal::make_nvp("concurrency", num_instances));
     m_printer->print_metadata(ar, Type{});
     operation::extra_serialization<Type>{ ar };
-    ar.setNextName("ranks");
-    ar.startNode();
-    ar.makeArray();
-    for(uint64_t i = 0; i < _results.size(); ++i)
-    {
-        if(_results.at(i).empty())
-            continue;
-
-        ar.startNode();
-
-        ar(cereal::make_nvp("rank", i));
-        save(ar, _results.at(i));
-
-        ar.finishNode();
-    }
-    ar.finishNode();  // ranks
+    serialize_ranks(ar);
     ar.finishNode();  // label
 }
 //
@@ -771,6 +1121,8 @@ public:
     TIMEMORY_NODISCARD inline size_t true_size() const { return 0; }
     TIMEMORY_NODISCARD inline size_t depth() const { return 0; }
 
+    static std::vector<storage_usage> usages() { return {}; }
+
     iterator pop() { return nullptr; }
     iterator insert(int64_t, const Type&, const string_t&) { return nullptr; }
 
@@ -257,6 +257,16 @@ storage<Type, true>::instance_count()
 //
 //--------------------------------------------------------------------------------------//
 //
+template <typename Type>
+std::atomic<int64_t>&
+storage<Type, true>::node_budget_count()
+{
+    static std::atomic<int64_t> _counter{ 0 };
+    return _counter;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
 //                                      FALSE
 //
 //--------------------------------------------------------------------------------------//
@@ -332,27 +342,8 @@ storage<Type, true>::storage()
 
     component::state<Type>::has_storage() = true;
 
-    static std::atomic<int32_t> _skip_once(0);
-    if(_skip_once++ > 0)
-    {
-        // make sure all worker instances have a copy of the hash id and aliases
-        auto _master = singleton_t::master_instance();
-        if(_master)
-        {
-            graph_hash_map_t   _hash_ids     = *_master->get_hash_ids();
-            graph_hash_alias_t _hash_aliases = *_master->get_hash_aliases();
-            for(const auto& itr : _hash_ids)
-            {
-                if(m_hash_ids->find(itr.first) == m_hash_ids->end())
-                    m_hash_ids->insert({ itr.first, itr.second });
-            }
-            for(const auto& itr : _hash_aliases)
-            {
-                if(m_hash_aliases->find(itr.first) == m_hash_aliases->end())
-                    m_hash_aliases->insert({ itr.first, itr.second });
-            }
-        }
-    }
+    // the lookup of a setting allocates the key so pop() reads the value directly
+    m_collapse_threshold = &m_settings->get_collapse_threshold();
 
     get_shared_manager();
     // m_printer = std::make_shared<printer_t>(Type::get_label(), this);
@@ -415,7 +406,22 @@ storage<Type, true>::finalize()
         return;
 
     if(m_settings->get_debug())
+    {
         PRINT_HERE("[%s]> finalizing...", m_label.c_str());
+        auto _total = m_child_hint_hits + m_child_hint_misses;
+        if(_total > 0)
+            PRINT_HERE("[%s]> child hint hit-rate: %.2f%% (%llu hits, %llu misses)",
+                       m_label.c_str(), 100.0 * m_child_hint_hits / _total,
+                       (unsigned long long) m_child_hint_hits,
+                       (unsigned long long) m_child_hint_misses);
+        if(m_folded_inserts > 0)
+            PRINT_HERE("[%s]> %llu insertions were folded into [other] nodes",
+                       m_label.c_str(), (unsigned long long) m_folded_inserts);
+        if(m_collapsed_inserts > 0)
+            PRINT_HERE("[%s]> %llu insertions were skipped for %i collapsed nodes",
+                       m_label.c_str(), (unsigned long long) m_collapsed_inserts,
+                       (int) collapsed_count());
+    }
 
     m_finalized            = true;
     worker_is_finalizing() = true;
@@ -452,6 +458,7 @@ storage<Type, true>::stack_clear()
         }
     }
     m_stack.clear();
+    storage_usage_counters::store(m_usage.stack, storage_usage::get_bytes(m_stack));
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -618,6 +625,14 @@ template <typename Type>
 typename storage<Type, true>::iterator
 storage<Type, true>::pop()
 {
+    // the outermost collapsed call did not change the current node
+    if(m_collapse_depth > 0)
+    {
+        --m_collapse_depth;
+        return _data().current();
+    }
+    if(*m_collapse_threshold > 0.0)
+        update_collapse(_data().current());
     return _data().pop_graph();
 }
 //
@@ -629,7 +644,10 @@ storage<Type, true>::stack_pop(Type* obj)
 {
     auto itr = m_stack.find(obj);
     if(itr != m_stack.end())
+    {
         m_stack.erase(itr);
+        storage_usage_counters::store(m_usage.stack, storage_usage::get_bytes(m_stack));
+    }
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -778,7 +796,8 @@ storage<Type, true>::_data()
         }
 
         if(m_node_ids.empty())
-            m_node_ids[0][0] = m_graph_data_instance->current();
+            m_node_ids.insert(0, 0, m_graph_data_instance->current());
+        update_usage();
     }
 
     m_initialized = true;
@@ -794,12 +813,27 @@ storage<Type, true>::merge()
     if(!m_is_master || !m_initialized)
         return;
 
+    merge_retired();
+
     auto m_children = singleton_t::children();
     if(m_children.empty())
         return;
 
-    for(auto& itr : m_children)
-        merge(itr);
+    auto _nthreads = m_settings->get_parallel_merge();
+    if(_nthreads > 1 && m_children.size() > 2)
+    {
+        operation::finalize::merge<Type, true>(
+            *this, std::vector<this_type*>{ m_children.begin(), m_children.end() },
+            _nthreads);
+    }
+    else
+    {
+        for(auto& itr : m_children)
+        {
+            if(itr)
+                operation::finalize::merge<Type, true>(*this, *itr);
+        }
+    }
 
     // create lock
     auto_lock_t l(singleton_t::get_mutex(), std::defer_lock);
@@ -809,10 +843,14 @@ storage<Type, true>::merge()
     for(auto& itr : m_children)
     {
         if(itr != this)
+        {
             itr->data().clear();
+            itr->reset_cursors();
+        }
     }
 
     stack_clear();
+    update_usage();
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -821,8 +859,117 @@ template <typename Type>
 void
 storage<Type, true>::merge(this_type* itr)
 {
-    if(itr)
+    if(!itr)
+        return;
+
+    // worker threads which exit before finalization are folded into an aggregate
+    // since the master thread may still be inserting into its graph
+    if(itr != this && m_is_master && !master_is_finalizing() &&
+       m_settings->get_incremental_merge())
+        retire(itr);
+    else
+        operation::finalize::merge<Type, true>(*this, *itr);
+    update_usage();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+void
+storage<Type, true>::retire(this_type* itr)
+{
+    if(!itr->is_initialized())
+        return;
+
+    // without a bookmark there is no known location in the master graph
+    if(!itr->m_graph_data_instance || itr->data().get_inverse_insert().empty())
+    {
         operation::finalize::merge<Type, true>(*this, *itr);
+        return;
+    }
+
+    itr->stack_clear();
+
+    if(m_settings->get_debug() || m_settings->get_verbose() > 2)
+        PRINT_HERE("[%s]> retiring %i records from worker thread %i", m_label.c_str(),
+                   (int) itr->size(), (int) itr->m_thread_idx);
+
+    {
+        std::unique_lock<std::mutex> _lk{ m_retired_mutex };
+        if(!m_retired)
+            m_retired = std::make_unique<graph_t>();
+        operation::finalize::merge<Type, true>(*m_retired, *itr);
+    }
+
+    // release the memory of the worker
+    itr->data().clear();
+    itr->reset_cursors();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+storage_usage
+storage<Type, true>::usage()
+{
+    // the containers of the thread are only read through the bytes which the thread
+    // stored after it modified them since this may be called by another thread
+    storage_usage _ret{};
+    _ret.tid   = m_thread_idx;
+    _ret.graph = storage_usage_counters::load(m_usage.graph);
+    {
+        std::lock_guard<std::mutex> _lk{ m_retired_mutex };
+        if(m_retired)
+            _ret.graph += sizeof(graph_t) + m_retired->get_allocator().alloc_bytes();
+    }
+    _ret.node_ids = storage_usage_counters::load(m_usage.node_ids);
+    if(m_hash_ids)
+        _ret.hash_ids = storage_usage::get_bytes(*m_hash_ids);
+    if(m_hash_aliases)
+        _ret.hash_aliases = storage_usage::get_bytes(*m_hash_aliases);
+    _ret.stack   = storage_usage_counters::load(m_usage.stack);
+    _ret.samples = storage_usage_counters::load(m_usage.samples);
+    return _ret;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+std::vector<storage_usage>
+storage<Type, true>::usages()
+{
+    std::vector<storage_usage> _ret{};
+    auto_lock_t                _lk{ singleton_t::get_mutex() };
+    auto*                      _master = singleton_t::master_instance_ptr();
+    if(!_master)
+        return _ret;
+    auto _children = singleton_t::children();
+    _ret.reserve(_children.size() + 1);
+    _ret.emplace_back(_master->usage());
+    for(auto* itr : _children)
+    {
+        if(itr && itr != _master)
+            _ret.emplace_back(itr->usage());
+    }
+    return _ret;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+void
+storage<Type, true>::merge_retired()
+{
+    std::unique_ptr<graph_t> _retired{};
+    {
+        std::unique_lock<std::mutex> _lk{ m_retired_mutex };
+        std::swap(_retired, m_retired);
+    }
+
+    if(!_retired || _retired->empty())
+        return;
+
+    operation::finalize::merge<Type, true>(*this, *_retired);
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -831,6 +978,9 @@ template <typename Type>
 typename storage<Type, true>::result_array_t
 storage<Type, true>::get()
 {
+    if(m_is_master)
+        merge_retired();
+
     result_array_t _ret;
     operation::finalize::get<Type, true>{ *this }(_ret);
     return _ret;
@@ -843,6 +993,9 @@ template <typename Tp>
 Tp&
 storage<Type, true>::get(Tp& _ret)
 {
+    if(m_is_master)
+        merge_retired();
+
     return operation::finalize::get<Type, true>{ *this }(_ret);
 }
 //
@@ -926,44 +1079,65 @@ storage<Type, true>::internal_print()
             singleton_t::master_instance()->merge(this);
         finalize();
     }
-    else
+    else if(!m_output_written)
     {
-        merge();
-        finalize();
+        if(internal_printer())
+            m_printer->execute();
 
-        if(!trait::runtime_enabled<Type>::get())
-        {
-            instance_count().store(0);
-            return;
-        }
+        instance_count().store(0);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+bool
+storage<Type, true>::internal_printer()
+{
+    merge();
+    finalize();
 
-        // if the graph wasn't ever initialized, exit
-        if(!m_graph_data_instance)
-        {
-            instance_count().store(0);
-            return;
-        }
+    if(!trait::runtime_enabled<Type>::get())
+        return false;
 
-        // no entries
-        if(_data().graph().size() <= 1)
-        {
-            instance_count().store(0);
-            return;
-        }
+    // if the graph wasn't ever initialized, exit
+    if(!m_graph_data_instance)
+        return false;
 
-        // generate output
-        if(m_settings->get_auto_output())
-        {
-            m_printer.reset(new printer_t(Type::get_label(), this, m_settings));
+    // no entries
+    if(_data().graph().size() <= 1)
+        return false;
 
-            if(m_manager)
-                m_manager->add_entries(this->size());
+    if(!m_settings->get_auto_output())
+        return false;
 
-            m_printer->execute();
-        }
+    m_printer.reset(new printer_t(Type::get_label(), this, m_settings));
 
-        instance_count().store(0);
-    }
+    if(m_manager)
+        m_manager->add_entries(this->size());
+
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+typename storage<Type, true>::output_task_t
+storage<Type, true>::internal_output()
+{
+    base::storage::stop_profiler();
+
+    output_task_t _task{};
+    if(m_output_written || (!m_initialized && !m_finalized))
+        return _task;
+
+    // the finalizer only releases this instance after the output is written
+    m_output_written = true;
+    if(internal_printer())
+        _task = m_printer->get_output_task();
+
+    instance_count().store(0);
+    return _task;
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -1006,9 +1180,10 @@ storage<Type, true>::get_shared_manager()
         auto _enabled = tim::get_env<bool>(env_var.str(), true);
         trait::runtime_enabled<Type>::set(_enabled);
 
-        bool   _is_master = singleton_t::is_master(this);
+        // the singleton does not know this instance until it is constructed
+        bool   _is_master = m_is_master;
         auto   _cleanup   = [&]() {};
-        func_t _finalize  = [&]() {
+        func_t _finalize  = [&, _is_master]() {
             auto _instance = this_type::get_singleton();
             if(_instance)
             {
@@ -1045,6 +1220,9 @@ storage<Type, true>::get_shared_manager()
 
         m_manager->add_finalizer(demangle<Type>(), std::move(_cleanup),
                                  std::move(_finalize), _is_master);
+
+        if(_is_master)
+            m_manager->add_output(demangle<Type>(), [&]() { return internal_output(); });
     }
 }
 //
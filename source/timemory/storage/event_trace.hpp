@@ -0,0 +1,845 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * \file timemory/storage/event_trace.hpp
+ * \brief Time-ordered tracing of the start and stop of components into per-thread
+ * ring buffers which are drained into a binary file by a background thread
+ */
+
+#pragma once
+
+#include "timemory/backends/dmp.hpp"
+#include "timemory/backends/process.hpp"
+#include "timemory/backends/threading.hpp"
+#include "timemory/components/properties.hpp"
+#include "timemory/hash/declaration.hpp"
+#include "timemory/macros/attributes.hpp"
+#include "timemory/mpl/type_traits.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/storage/output_format.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+/// \namespace tim::event_trace
+/// \brief When \ref tim::event_trace::enabled is true (TIMEMORY_EVENT_TRACE), pushing
+/// a component does not insert a node into the call-graph. The push and pop of the
+/// component instead append a \ref tim::event_trace::record to a lock-free ring buffer
+/// of the thread and a background thread writes the records to
+/// <OUTPUT_PATH>/<OUTPUT_PREFIX>event-trace.bin.
+///
+/// The file starts with a \ref tim::event_trace::file_header followed by the records
+/// of each thread in time order and ends with the tables of the component labels and
+/// units and of the labels of the hash ids.
+namespace event_trace
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+enum class phase : uint8_t
+{
+    begin = 0,
+    end   = 1
+};
+//
+/// what a thread does when its ring buffer is full
+enum class overflow : uint8_t
+{
+    drop = 0,   ///< discard the new record
+    overwrite,  ///< discard the oldest record
+    block       ///< wait for the writer to drain the buffer
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::event_trace::record
+/// \brief A fixed-size record of the start or stop of a component. When it is
+/// stopped, the value is the change of the value of the component (get()) over the
+/// interval, so a component which is started and stopped repeatedly does not record
+/// its accumulated value. When it is started, the value is zero unless the component is
+/// a counter (\ref type_info::counter), e.g. page_rss, in which case it is the current
+/// value of the counter (record()) so that the sum of the two values is the value of
+/// the counter when it is stopped.
+struct record
+{
+    int64_t  timestamp = 0;  ///< steady clock in nanoseconds
+    uint64_t hash      = 0;  ///< hash id of the label
+    double   value     = 0.0;
+    uint32_t tid       = 0;  ///< timemory thread id
+    uint16_t type      = 0;  ///< index of the component in the type table
+    uint8_t  phase     = 0;  ///< \ref tim::event_trace::phase
+    uint8_t  reserved  = 0;
+};
+//
+static_assert(sizeof(record) == 32, "event_trace::record should be 32 bytes");
+static_assert(std::is_trivially_copyable<record>::value,
+              "event_trace::record should be trivially copyable");
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::event_trace::file_header
+/// \brief The header of the binary file. The endian tag is written in the byte order
+/// of the writer. The offset of the tables is zero until the file is closed.
+///
+/// The tables are:
+///   - uint64: number of types, then for each type: label, unit, uint32 counter flag
+///   - uint64: number of hashes, then for each hash: uint64 hash, label
+///   - uint64: number of records, records dropped, records overwritten
+///
+/// where the strings are a uint32 length followed by the characters.
+struct file_header
+{
+    char     magic[8]    = { 'T', 'I', 'M', 'T', 'R', 'A', 'C', 'E' };
+    uint32_t version     = 1;
+    uint32_t endian      = 0x01020304;
+    uint32_t record_size = sizeof(record);
+    uint32_t pid         = 0;
+    uint64_t tables      = 0;
+};
+//
+static_assert(sizeof(file_header) == 32, "event_trace::file_header should be 32 bytes");
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::event_trace::ring_buffer
+/// \brief Single-producer single-consumer ring buffer of records. The thread which
+/// owns the buffer pushes and the writer drains. In the overwrite mode the producer
+/// also advances the read index so the consumer only keeps a record if it advanced
+/// the read index past it before the producer did. Since the producer may then
+/// overwrite a slot while the consumer copies it, the slots are copied through atomic
+/// words and a torn copy is discarded with the slot.
+class ring_buffer
+{
+    static constexpr size_t slot_words = sizeof(record) / sizeof(uint64_t);
+
+    struct slot
+    {
+        std::atomic<uint64_t> words[slot_words];
+    };
+
+public:
+    ring_buffer(size_t _capacity, overflow _policy, const std::atomic<bool>* _draining)
+    : m_policy{ _policy }
+    , m_draining{ _draining }
+    {
+        size_t _n = 2;
+        while(_n < _capacity)
+            _n <<= 1;
+        m_mask = _n - 1;
+        m_data.reset(new slot[_n]());
+    }
+
+    ring_buffer(const ring_buffer&) = delete;
+    ring_buffer& operator=(const ring_buffer&) = delete;
+
+    size_t   capacity() const { return m_mask + 1; }
+    size_t   size() const { return m_write.load() - m_read.load(); }
+    bool     empty() const { return m_write.load() == m_read.load(); }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    uint64_t overwritten() const
+    {
+        return m_overwritten.load(std::memory_order_relaxed);
+    }
+
+    /// returns the number of records in the buffer after the push
+    size_t push(const record& _v)
+    {
+        auto _w = m_write.load(std::memory_order_relaxed);
+        auto _r = m_read.load(std::memory_order_acquire);
+        while(_w - _r > m_mask)
+        {
+            if(m_policy == overflow::overwrite)
+            {
+                auto _order = std::memory_order_acq_rel;
+                if(m_read.compare_exchange_weak(_r, _r + 1, _order))
+                {
+                    m_overwritten.fetch_add(1, std::memory_order_relaxed);
+                    ++_r;
+                }
+            }
+            else if(m_policy == overflow::block && m_draining &&
+                    m_draining->load(std::memory_order_relaxed))
+            {
+                std::this_thread::yield();
+                _r = m_read.load(std::memory_order_acquire);
+            }
+            else
+            {
+                // dropped or blocked without a writer draining the buffer
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return _w - _r;
+            }
+        }
+        store(m_data[_w & m_mask], _v);
+        m_write.store(_w + 1, std::memory_order_release);
+        return _w + 1 - _r;
+    }
+
+    /// invokes the function with each record in order and returns the number of
+    /// records
+    template <typename FuncT>
+    size_t drain(FuncT&& _func)
+    {
+        size_t _n = 0;
+        auto   _r = m_read.load(std::memory_order_acquire);
+        while(_r != m_write.load(std::memory_order_acquire))
+        {
+            record _v = load(m_data[_r & m_mask]);
+            // on failure _r is the index the producer advanced to
+            if(m_read.compare_exchange_strong(_r, _r + 1, std::memory_order_acq_rel))
+            {
+                _func(_v);
+                ++_n;
+                ++_r;
+            }
+        }
+        return _n;
+    }
+
+private:
+    static void store(slot& _slot, const record& _v)
+    {
+        uint64_t _words[slot_words];
+        std::memcpy(_words, &_v, sizeof(record));
+        for(size_t i = 0; i < slot_words; ++i)
+            _slot.words[i].store(_words[i], std::memory_order_relaxed);
+    }
+
+    static record load(const slot& _slot)
+    {
+        uint64_t _words[slot_words];
+        for(size_t i = 0; i < slot_words; ++i)
+            _words[i] = _slot.words[i].load(std::memory_order_relaxed);
+        record _v{};
+        std::memcpy(&_v, _words, sizeof(record));
+        return _v;
+    }
+
+private:
+    overflow                 m_policy      = overflow::drop;
+    const std::atomic<bool>* m_draining    = nullptr;
+    size_t                   m_mask        = 0;
+    std::atomic<uint64_t>    m_dropped     = { 0 };
+    std::atomic<uint64_t>    m_overwritten = { 0 };
+    alignas(64) std::atomic<uint64_t> m_read  = { 0 };
+    alignas(64) std::atomic<uint64_t> m_write = { 0 };
+    std::unique_ptr<slot[]> m_data = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the label and display unit of each traced component, the index into this table is
+/// \ref record::type
+struct type_info
+{
+    std::string label   = {};
+    std::string unit    = {};
+    bool        counter = false;  ///< the value is a quantity which can be plotted
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::event_trace::config
+/// \brief The configuration of the tracing, read from the settings by \ref configure
+struct config
+{
+    size_t                    buffer_size = 65536;
+    overflow                  policy      = overflow::drop;
+    std::chrono::milliseconds interval    = std::chrono::milliseconds{ 10 };
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::event_trace::writer
+/// \brief Owns the ring buffers of the threads and the background thread which drains
+/// them into the file. The buffers are shared with the threads so the records of a
+/// thread which exited are still written.
+class writer
+{
+public:
+    using buffer_ptr_t = std::shared_ptr<ring_buffer>;
+
+    writer() = default;
+    ~writer() { stop(false); }
+
+    writer(const writer&) = delete;
+    writer& operator=(const writer&) = delete;
+
+    config& get_config() { return m_config; }
+
+    /// creates the buffer of a thread and starts the background thread
+    buffer_ptr_t add_buffer()
+    {
+        std::lock_guard<std::mutex> _lk{ m_mutex };
+        auto _buffer = std::make_shared<ring_buffer>(m_config.buffer_size,
+                                                     m_config.policy, &m_running);
+        m_buffers.emplace_back(_buffer);
+        if(!m_running.load() && !m_stopped)
+        {
+            m_running.store(true);
+            m_thread = std::thread{ &writer::execute, this };
+        }
+        return _buffer;
+    }
+
+    /// returns the index of the component in the type table
+    uint16_t add_type(std::string _label, std::string _unit, bool _counter)
+    {
+        std::lock_guard<std::mutex> _lk{ m_mutex };
+        m_types.emplace_back(type_info{ std::move(_label), std::move(_unit), _counter });
+        return static_cast<uint16_t>(m_types.size() - 1);
+    }
+
+    /// wakes up the background thread before the end of the interval
+    void notify() { m_cv.notify_one(); }
+
+    /// stops the background thread, writes the remaining records and the tables and
+    /// closes the file. Records pushed afterwards are not written.
+    void stop(bool _report = true)
+    {
+        {
+            std::lock_guard<std::mutex> _lk{ m_mutex };
+            if(m_stopped)
+                return;
+            m_stopped = true;
+        }
+        if(m_thread.joinable())
+        {
+            m_running.store(false);
+            m_cv.notify_one();
+            m_thread.join();
+        }
+        std::lock_guard<std::mutex> _lk{ m_mutex };
+        drain(m_buffers);
+        close(_report);
+    }
+
+    const std::string& get_filename() const { return m_filename; }
+    uint64_t           get_count() const { return m_count; }
+
+private:
+    void execute()
+    {
+        std::unique_lock<std::mutex> _lk{ m_mutex };
+        while(m_running.load())
+        {
+            m_cv.wait_for(_lk, m_config.interval);
+            // the records are written without the mutex so a thread which traces its
+            // first component does not wait for the file in add_buffer
+            auto _buffers = m_buffers;
+            _lk.unlock();
+            drain(_buffers);
+            _buffers.clear();
+            _lk.lock();
+            release();
+        }
+    }
+
+    // writes the records of the buffers. Only the background thread writes until it
+    // is joined by stop()
+    void drain(const std::vector<buffer_ptr_t>& _buffers)
+    {
+        for(const auto& itr : _buffers)
+        {
+            m_records.clear();
+            itr->drain([this](const record& _v) {
+                m_records.emplace_back(_v);
+                m_hashes.insert(_v.hash);
+            });
+            if(!m_records.empty() && open())
+            {
+                m_ofs.write(reinterpret_cast<const char*>(m_records.data()),
+                            m_records.size() * sizeof(record));
+                m_count += m_records.size();
+            }
+        }
+    }
+
+    // releases the buffers of the threads which exited, the caller holds the mutex
+    void release()
+    {
+        auto _expired = [this](const buffer_ptr_t& _v) {
+            if(_v.use_count() > 1 || !_v->empty())
+                return false;
+            m_dropped += _v->dropped();
+            m_overwritten += _v->overwritten();
+            return true;
+        };
+        m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), _expired),
+                        m_buffers.end());
+    }
+
+    bool open()
+    {
+        if(m_ofs.is_open())
+            return true;
+        if(!m_filename.empty())
+            return false;
+        m_filename = settings::compose_output_filename(
+            "event-trace", "bin", dmp::is_initialized(), dmp::rank());
+        m_ofs.open(m_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!m_ofs)
+        {
+            fprintf(stderr, "[event_trace]> Error opening '%s'. Events are discarded\n",
+                    m_filename.c_str());
+            return false;
+        }
+        file_header _header{};
+        _header.pid = static_cast<uint32_t>(process::get_id());
+        m_ofs.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+        return true;
+    }
+
+    void close(bool _report)
+    {
+        for(auto& itr : m_buffers)
+        {
+            m_dropped += itr->dropped();
+            m_overwritten += itr->overwritten();
+        }
+        m_buffers.clear();
+
+        if(!m_ofs.is_open())
+            return;
+
+        auto _write_string = [this](const std::string& _v) {
+            auto _n = static_cast<uint32_t>(_v.length());
+            m_ofs.write(reinterpret_cast<const char*>(&_n), sizeof(_n));
+            m_ofs.write(_v.data(), _n);
+        };
+        auto _write_int = [this](uint64_t _v) {
+            m_ofs.write(reinterpret_cast<const char*>(&_v), sizeof(_v));
+        };
+
+        uint64_t _tables = m_ofs.tellp();
+        _write_int(m_types.size());
+        for(const auto& itr : m_types)
+        {
+            _write_string(itr.label);
+            _write_string(itr.unit);
+            uint32_t _counter = (itr.counter) ? 1 : 0;
+            m_ofs.write(reinterpret_cast<const char*>(&_counter), sizeof(_counter));
+        }
+        _write_int(m_hashes.size());
+        for(const auto& itr : m_hashes)
+        {
+            _write_int(itr);
+            _write_string(get_hash_identifier(itr));
+        }
+        _write_int(m_count);
+        _write_int(m_dropped);
+        _write_int(m_overwritten);
+
+        m_ofs.seekp(offsetof(file_header, tables));
+        _write_int(_tables);
+        m_ofs.close();
+
+        if(_report && settings::verbose() >= 0)
+        {
+            fprintf(stderr,
+                    "[event_trace]> Outputting '%s' (%llu events, %llu dropped, %llu "
+                    "overwritten)...\n",
+                    m_filename.c_str(),
+                    (unsigned long long) m_count, (unsigned long long) m_dropped,
+                    (unsigned long long) m_overwritten);
+        }
+    }
+
+private:
+    bool                         m_stopped     = false;
+    std::atomic<bool>            m_running     = { false };
+    uint64_t                     m_count       = 0;
+    uint64_t                     m_dropped     = 0;
+    uint64_t                     m_overwritten = 0;
+    config                       m_config      = {};
+    std::mutex                   m_mutex       = {};
+    std::condition_variable      m_cv          = {};
+    std::thread                  m_thread      = {};
+    std::string                  m_filename    = {};
+    std::ofstream                m_ofs         = {};
+    std::vector<buffer_ptr_t>    m_buffers     = {};
+    std::vector<type_info>       m_types       = {};
+    std::vector<record>          m_records     = {};
+    std::unordered_set<uint64_t> m_hashes      = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::event_trace::reader
+/// \brief Reads a file written by the \ref tim::event_trace::writer. The tables are
+/// read when the file is opened and the records are streamed in blocks so that the
+/// file is never held in memory. The records of a file which was not closed (the
+/// tables offset is zero) are read up to the end of the file.
+class reader
+{
+public:
+    using label_map_t = std::unordered_map<uint64_t, std::string>;
+
+    explicit reader(std::string _filename, size_t _block_size = 4096)
+    : m_block_size{ std::max<size_t>(_block_size, 1) }
+    , m_filename{ std::move(_filename) }
+    {
+        open();
+    }
+
+    bool                          is_valid() const { return m_error.empty(); }
+    const std::string&            get_error() const { return m_error; }
+    const std::string&            get_filename() const { return m_filename; }
+    const file_header&            get_header() const { return m_header; }
+    const std::vector<type_info>& get_types() const { return m_types; }
+    const label_map_t&            get_labels() const { return m_labels; }
+    uint64_t                      get_count() const { return m_count; }
+    uint64_t                      get_dropped() const { return m_dropped; }
+    uint64_t                      get_overwritten() const { return m_overwritten; }
+
+    /// the label of the hash id or the hash id if it is not in the table
+    std::string get_label(uint64_t _hash) const
+    {
+        auto itr = m_labels.find(_hash);
+        return (itr != m_labels.end()) ? itr->second : std::to_string(_hash);
+    }
+
+    /// invokes the function with each record in the order of the file and returns the
+    /// number of records
+    template <typename FuncT>
+    uint64_t read(FuncT&& _func)
+    {
+        if(!is_valid())
+            return 0;
+        std::ifstream _ifs{ m_filename, std::ios::in | std::ios::binary };
+        _ifs.seekg(sizeof(file_header));
+        std::vector<record> _block(m_block_size);
+        uint64_t            _n = 0;
+        while(_n < m_count && _ifs)
+        {
+            auto _nread = std::min<uint64_t>(m_count - _n, _block.size());
+            _ifs.read(reinterpret_cast<char*>(_block.data()), _nread * sizeof(record));
+            _nread = _ifs.gcount() / sizeof(record);
+            for(uint64_t i = 0; i < _nread; ++i)
+                _func(_block[i]);
+            _n += _nread;
+        }
+        return _n;
+    }
+
+private:
+    void open()
+    {
+        std::ifstream _ifs{ m_filename, std::ios::in | std::ios::binary };
+        if(!_ifs)
+        {
+            m_error = "unable to open '" + m_filename + "'";
+            return;
+        }
+        _ifs.seekg(0, std::ios::end);
+        uint64_t _size = _ifs.tellg();
+        _ifs.seekg(0, std::ios::beg);
+
+        file_header _ref{};
+        if(!_ifs.read(reinterpret_cast<char*>(&m_header), sizeof(m_header)) ||
+           !std::equal(std::begin(_ref.magic), std::end(_ref.magic), m_header.magic))
+            m_error = "'" + m_filename + "' is not an event trace";
+        else if(m_header.endian != _ref.endian)
+            m_error = "'" + m_filename + "' was written with a different byte order";
+        else if(m_header.version != _ref.version)
+            m_error = "'" + m_filename + "' has an unsupported version (" +
+                      std::to_string(m_header.version) + ")";
+        else if(m_header.record_size != sizeof(record) || m_header.tables > _size ||
+                (m_header.tables > 0 && m_header.tables < sizeof(file_header)))
+            m_error = "'" + m_filename + "' is corrupted";
+        if(!is_valid())
+            return;
+
+        auto _end = (m_header.tables > 0) ? m_header.tables : _size;
+        m_count   = (_end - sizeof(file_header)) / sizeof(record);
+        if(m_header.tables == 0)
+            return;
+
+        auto _read_int = [&_ifs]() {
+            uint64_t _v = 0;
+            _ifs.read(reinterpret_cast<char*>(&_v), sizeof(_v));
+            return _v;
+        };
+        auto _read_string = [&_ifs, _size]() {
+            uint32_t _n = 0;
+            _ifs.read(reinterpret_cast<char*>(&_n), sizeof(_n));
+            if(!_ifs || _n > _size)
+            {
+                _ifs.setstate(std::ios::failbit);
+                return std::string{};
+            }
+            std::string _v(_n, '\0');
+            _ifs.read(&_v[0], _n);
+            return _v;
+        };
+
+        _ifs.seekg(m_header.tables);
+        auto _ntypes = _read_int();
+        for(uint64_t i = 0; i < _ntypes && _ifs; ++i)
+        {
+            type_info _v{};
+            _v.label          = _read_string();
+            _v.unit           = _read_string();
+            uint32_t _counter = 0;
+            _ifs.read(reinterpret_cast<char*>(&_counter), sizeof(_counter));
+            _v.counter = (_counter != 0);
+            m_types.emplace_back(std::move(_v));
+        }
+        auto _nlabels = _read_int();
+        for(uint64_t i = 0; i < _nlabels && _ifs; ++i)
+        {
+            auto _hash      = _read_int();
+            m_labels[_hash] = _read_string();
+        }
+        _read_int();  // number of records written
+        m_dropped     = _read_int();
+        m_overwritten = _read_int();
+        if(!_ifs)
+            m_error = "'" + m_filename + "' has corrupted tables";
+    }
+
+private:
+    size_t                 m_block_size  = 4096;
+    uint64_t               m_count       = 0;
+    uint64_t               m_dropped     = 0;
+    uint64_t               m_overwritten = 0;
+    std::string            m_filename    = {};
+    std::string            m_error       = {};
+    file_header            m_header      = {};
+    std::vector<type_info> m_types       = {};
+    label_map_t            m_labels      = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+std::atomic<bool>&
+enabled() TIMEMORY_VISIBILITY("default");
+//
+writer&
+get_writer() TIMEMORY_VISIBILITY("default");
+//
+/// whether the component is traced when it is pushed
+inline std::atomic<bool>&
+enabled()
+{
+    static std::atomic<bool> _instance{ false };
+    return _instance;
+}
+//
+inline writer&
+get_writer()
+{
+    static writer _instance{};
+    return _instance;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// reads TIMEMORY_EVENT_TRACE and the buffer settings. The buffer settings apply to
+/// the buffers of the threads which have not traced a component yet
+inline void
+configure()
+{
+    auto& _cfg       = get_writer().get_config();
+    _cfg.buffer_size = std::max<size_t>(settings::event_trace_buffer_size(), 2);
+    auto _policy     = settings::event_trace_overflow();
+    std::transform(_policy.begin(), _policy.end(), _policy.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    if(_policy == "overwrite")
+        _cfg.policy = overflow::overwrite;
+    else if(_policy == "block")
+        _cfg.policy = overflow::block;
+    else
+        _cfg.policy = overflow::drop;
+    enabled() = settings::event_trace();
+}
+//
+/// stops the tracing and closes the file
+inline void
+finalize()
+{
+    enabled() = false;
+    get_writer().stop();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline ring_buffer&
+get_buffer()
+{
+    static thread_local auto _instance = get_writer().add_buffer();
+    return *_instance;
+}
+//
+inline int64_t
+now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+//
+/// the display unit of components with a single value, empty otherwise
+using output_format::get_unit;
+//
+/// the current value of a counter, e.g. the current page_rss, in the display unit
+template <typename Tp>
+auto
+get_counter(int)
+    -> decltype(static_cast<double>(Tp::record()) / static_cast<double>(Tp::get_unit()))
+{
+    return static_cast<double>(Tp::record()) / static_cast<double>(Tp::get_unit());
+}
+//
+template <typename Tp>
+double
+get_counter(long)
+{
+    return 0.0;
+}
+//
+template <typename Tp>
+auto
+is_counter(int) -> decltype(static_cast<double>(Tp::record()), bool{})
+{
+    return true;
+}
+//
+template <typename Tp>
+bool
+is_counter(long)
+{
+    return false;
+}
+//
+template <typename Tp>
+uint16_t
+get_type_index()
+{
+    static uint16_t _instance = get_writer().add_type(
+        Tp::get_label(), get_unit<Tp>(0),
+        trait::is_memory_category<Tp>::value && is_counter<Tp>(0));
+    return _instance;
+}
+//
+/// a component of the thread which was pushed, the hash of its label and its value
+/// (get()) when it was pushed
+template <typename Tp>
+struct stack_entry
+{
+    const Tp* object = nullptr;
+    uint64_t  hash   = 0;
+    double    value  = 0.0;
+};
+//
+template <typename Tp>
+std::vector<stack_entry<Tp>>&
+get_hash_stack()
+{
+    static thread_local std::vector<stack_entry<Tp>> _instance{};
+    return _instance;
+}
+//
+template <typename Tp>
+auto
+get_value(const Tp& _obj, int) -> decltype(static_cast<double>(_obj.get()))
+{
+    return static_cast<double>(_obj.get());
+}
+//
+template <typename Tp>
+double
+get_value(const Tp&, long)
+{
+    return 0.0;
+}
+//
+inline void
+append(const record& _v)
+{
+    auto& _buffer = get_buffer();
+    if(_buffer.push(_v) == _buffer.capacity() / 2)
+        get_writer().notify();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// records the start of the component
+template <typename Tp>
+void
+push(const Tp& _obj, uint64_t _hash)
+{
+    auto _base = get_value(_obj, 0);
+    get_hash_stack<Tp>().emplace_back(stack_entry<Tp>{ &_obj, _hash, _base });
+    auto _value = (trait::is_memory_category<Tp>::value) ? get_counter<Tp>(0) : 0.0;
+    append(record{ now(), _hash, _value, static_cast<uint32_t>(threading::get_id()),
+                   get_type_index<Tp>(), static_cast<uint8_t>(phase::begin), 0 });
+}
+//
+/// records the stop of the component, returns false if the component was not pushed
+/// while tracing
+template <typename Tp>
+bool
+pop(const Tp& _obj)
+{
+    auto& _stack = get_hash_stack<Tp>();
+    for(auto itr = _stack.rbegin(); itr != _stack.rend(); ++itr)
+    {
+        if(itr->object != &_obj)
+            continue;
+        auto _hash  = itr->hash;
+        auto _value = get_value(_obj, 0) - itr->value;
+        _stack.erase(std::next(itr).base());
+        append(record{ now(), _hash, _value,
+                       static_cast<uint32_t>(threading::get_id()), get_type_index<Tp>(),
+                       static_cast<uint8_t>(phase::end), 0 });
+        return true;
+    }
+    return false;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace event_trace
+}  // namespace tim
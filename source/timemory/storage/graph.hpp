@@ -30,8 +30,10 @@
 #include "timemory/tpls/cereal/cereal.hpp"
 #include "timemory/units.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdlib>
 #include <deque>
 #include <functional>
 #include <iomanip>
@@ -41,6 +43,7 @@
 #include <queue>
 #include <set>
 #include <stdexcept>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -78,6 +81,7 @@ public:
     tgraph_node<T>* last_child   = nullptr;
     tgraph_node<T>* prev_sibling = nullptr;
     tgraph_node<T>* next_sibling = nullptr;
+    tgraph_node<T>* child_hint   = nullptr;  // child most recently located/inserted
     T               data         = T{};
 
     //----------------------------------------------------------------------------------//
@@ -104,16 +108,21 @@ tgraph_node<T>::tgraph_node(T&& val) noexcept
 {}
 
 //======================================================================================//
-//  graph allocator that counts the size of the allocation (unused)
+//  page-based slab allocator for the graph nodes
 //
-//
-#if defined(TIMEMORY_GRAPH_ALLOCATOR)
-
+/// \class tim::graph_allocator
+/// \brief Allocator for \ref tim::tgraph_node instances which carves the nodes out of
+/// page-sized blocks instead of allocating each node individually. Erased nodes are
+/// recycled through a free-list (there is no per-node call to free) and all of the
+/// blocks are released at once when the graph is cleared or destroyed. Copies of the
+/// allocator share the same set of blocks so that the nodes of a graph which is moved
+/// remain valid. This allocator is not thread-safe: each graph (and thus each
+/// thread-specific storage instance) owns its own set of blocks.
+///
 template <typename Tp>
-class graph_allocator : public std::allocator<Tp>
+class graph_allocator
 {
 public:
-    // The following will be the same for virtually all allocators.
     using value_type      = Tp;
     using pointer         = Tp*;
     using reference       = Tp&;
@@ -121,51 +130,76 @@ public:
     using const_reference = const Tp&;
     using size_type       = size_t;
     using difference_type = ptrdiff_t;
-    using boolvec_t       = std::deque<bool>;
-    using voidvec_t       = std::vector<void*>;
-    using sizevec_t       = std::vector<uint16_t>;
-    using base_type       = std::allocator<Tp>;
 
-public:
-    // constructors and destructors
-    graph_allocator()                           = default;
-    graph_allocator(const graph_allocator&)     = delete;
-    graph_allocator(graph_allocator&&) noexcept = default;
-    ~graph_allocator()
+    template <typename Up>
+    struct rebind
     {
-        for(auto& itr : m_allocations)
-            free(itr);
-    }
+        using other = graph_allocator<Up>;
+    };
+
+private:
+    struct arena
+    {
+        arena()  = default;
+        ~arena() { release(); }
+
+        arena(const arena&) = delete;
+        arena(arena&&)      = delete;
+        arena& operator=(const arena&) = delete;
+        arena& operator=(arena&&) = delete;
+
+        void release()
+        {
+            for(auto& itr : blocks)
+                free(itr);
+            blocks.clear();
+            next      = nullptr;
+            last      = nullptr;
+            free_list = nullptr;
+            nbytes    = 0;
+            npages    = 1;
+        }
+
+        std::vector<void*> blocks    = {};
+        char*              next      = nullptr;
+        char*              last      = nullptr;
+        void*              free_list = nullptr;
+        size_t             nbytes    = 0;
+        size_t             npages    = 1;
+    };
 
 public:
-    // operators
-    graph_allocator& operator=(const graph_allocator&) = delete;
-    graph_allocator& operator==(graph_allocator&&)     = delete;
-    bool operator!=(const graph_allocator& other) const { return !(*this == other); }
-    bool operator==(const graph_allocator&) const { return true; }
+    // the blocks grow geometrically from a single page up to this many pages
+    static constexpr size_t max_pages_per_block = 64;
+
+    graph_allocator()
+    : m_arena(std::make_shared<arena>())
+    {}
+
+    ~graph_allocator()                          = default;
+    graph_allocator(const graph_allocator&)     = default;
+    graph_allocator(graph_allocator&&) noexcept = default;
+    graph_allocator& operator=(const graph_allocator&) = default;
+    graph_allocator& operator=(graph_allocator&&) noexcept = default;
+
+    template <typename Up>
+    graph_allocator(const graph_allocator<Up>&)
+    : m_arena(std::make_shared<arena>())
+    {}
+
+    bool operator==(const graph_allocator& rhs) const { return m_arena == rhs.m_arena; }
+    bool operator!=(const graph_allocator& rhs) const { return !(*this == rhs); }
 
 public:
     Tp*       address(Tp& r) const { return &r; }
     const Tp* address(const Tp& s) const { return &s; }
 
-    size_t max_size() const
+    TIMEMORY_NODISCARD size_t max_size() const
     {
         // avoid signed/unsigned warnings independent of size_t definition
         return (static_cast<size_t>(0) - static_cast<size_t>(1)) / sizeof(Tp);
     }
 
-    // The following must be the same for all allocators.
-    template <typename U>
-    struct rebind
-    {
-        typedef graph_allocator<U> other;
-    };
-
-    // using base_type::construct;
-    // using base_type::destroy;
-
-    void construct(Tp* const p, const Tp& val) const { ::new((void*) p) Tp(val); }
-
     template <typename... ArgsT>
     void construct(Tp* const p, ArgsT&&... args) const
     {
@@ -174,8 +208,11 @@ public:
 
     void destroy(Tp* const p) const { p->~Tp(); }
 
-    Tp* allocate(const size_t n) const
+    Tp* allocate(const size_t n, const void* = nullptr)
     {
+        static_assert(sizeof(Tp) >= sizeof(void*),
+                      "graph_allocator requires the value type to hold a pointer");
+
         if(n == 0)
             return nullptr;
 
@@ -186,144 +223,96 @@ public:
                 "graph_allocator<Tp>::allocate() - Integer overflow.");
         }
 
-        auto _check_page_entry = [&](size_t i, size_t& j) -> Tp* {
-            if(m_offset_avail[i][j])
-            {
-                bool _block = true;
-                for(size_t k = 1; k < n; ++k)
-                    if(!m_offset_avail[i][j + k])
-                    {
-                        _block = false;
-                        j += k + 1;
-                        break;
-                    }
-                if(_block)
-                {
-                    Tp* ptr = ((Tp*) m_pages[i]) + j;
-                    for(size_t k = 0; k < n; ++k)
-                        m_offset_avail[i][j + k] = false;
-                    m_offset_empty[i] -= n;
-                    return ptr;
-                }
-            }
-            return nullptr;
-        };
-
-        if(!m_next_addr)
-            add_pages(1);
-
-        if(m_next_offset < m_alloc_per_page && m_offset_empty[m_next_page] >= n)
+        auto& _arena = *m_arena;
+        if(n == 1 && _arena.free_list)
         {
-            for(size_t j = m_next_offset; j < m_offset_avail[m_next_page].size(); ++j)
-            {
-                auto _ptr = _check_page_entry(m_next_page, j);
-                if(_ptr)
-                {
-                    m_next_offset += n;
-                    return _ptr;
-                }
-            }
+            void* _ptr       = _arena.free_list;
+            _arena.free_list = *static_cast<void**>(_ptr);
+            return static_cast<Tp*>(_ptr);
         }
 
-        // Mallocator wraps malloc().
-        for(size_t i = 0; i < m_pages.size(); ++i)
-        {
-            if(m_offset_empty[i] >= n)
-            {
-                for(size_t j = 0; j < m_offset_avail[i].size(); ++j)
-                {
-                    auto _ptr = _check_page_entry(i, j);
-                    if(_ptr)
-                        return _ptr;
-                }
-            }
-        }
+        auto _nbytes = n * sizeof(Tp);
+        if(_arena.next == nullptr ||
+           static_cast<size_t>(_arena.last - _arena.next) < _nbytes)
+            add_block(_nbytes);
 
-        add_pages(1);
-        for(size_t k = 0; k < n; ++k)
-            m_offset_avail[m_next_page][m_next_offset + k] = false;
-        m_offset_empty[m_next_page] -= n;
-        m_next_offset += n;
-        return static_cast<Tp*>(m_next_addr);
+        auto* _ptr = _arena.next;
+        _arena.next += _nbytes;
+        return reinterpret_cast<Tp*>(_ptr);
     }
 
-    void deallocate(Tp* const ptr, const size_t n) const
+    void deallocate(Tp* const ptr, const size_t n)
     {
-        for(size_t j = 0; j < n; ++j)
+        if(ptr == nullptr)
+            return;
+        // recycle through the free-list, memory is only returned in release()
+        auto& _arena = *m_arena;
+        for(size_t i = 0; i < n; ++i)
         {
-            char* _ptr = (char*) ptr + j;
-            for(size_t i = 0; i < m_pages.size(); ++i)
-            {
-                auto itr  = m_pages[i];
-                auto dist = std::distance((char*) itr, _ptr);
-                if(dist >= 0 && dist < units::get_page_size())
-                {
-                    m_offset_avail[i][dist] = true;
-                    m_offset_empty[i] += 1;
-                }
-            }
+            void* _ptr                 = static_cast<void*>(ptr + i);
+            *static_cast<void**>(_ptr) = _arena.free_list;
+            _arena.free_list           = _ptr;
         }
     }
 
-    // same for all allocators that ignore hints.
-    // template <typename U = Tp>
-    Tp* allocate(const size_t n, const void* /* const hint */) const
+    /// pre-allocate enough memory for at least \param n objects
+    void reserve(const size_t n)
     {
-        return allocate(n);
+        auto& _arena  = *m_arena;
+        auto  _nbytes = n * sizeof(Tp);
+        if(_arena.next == nullptr ||
+           static_cast<size_t>(_arena.last - _arena.next) < _nbytes)
+            add_block(_nbytes);
     }
 
-    size_t alloc_bytes() const { return units::get_page_size() * m_pages.size(); }
+    /// free all the blocks at once. Only valid when no constructed objects remain
+    void release() { m_arena->release(); }
 
-    void reserve(const size_t n)
-    {
-        auto npages = n / m_alloc_per_page + 1;
-        add_pages(npages);
-    }
+    /// number of bytes currently reserved from the system
+    TIMEMORY_NODISCARD size_t alloc_bytes() const { return m_arena->nbytes; }
+
+    /// number of allocator instances sharing the blocks
+    TIMEMORY_NODISCARD long use_count() const { return m_arena.use_count(); }
 
 private:
-    void add_pages(int npages = 1) const
+    void add_block(size_t _min_bytes)
     {
-        auto  nbytes = npages * units::get_page_size();
-        void* _space = malloc(nbytes);
-        m_allocations.push_back(_space);
+        auto& _arena   = *m_arena;
+        auto  _pagesz  = static_cast<size_t>(units::get_page_size());
+        auto  _nbytes  = _arena.npages * _pagesz;
+        auto  _nobject = std::max<size_t>(_nbytes / sizeof(Tp), 1);
+        _nbytes        = std::max<size_t>(_nobject * sizeof(Tp), _min_bytes);
 
+        void* _space = malloc(_nbytes);
         // throw std::bad_alloc in the case of memory allocation failure.
         if(_space == nullptr)
         {
             std::cerr << "Allocation of type " << typeid(Tp).name() << " of size "
-                      << nbytes << " failed" << std::endl;
+                      << _nbytes << " failed" << std::endl;
             throw std::bad_alloc();
         }
 
-        auto _num_pages = m_pages.size();
-        m_next_page     = m_pages.size();
-        m_next_addr     = _space;
-        m_next_offset   = 0;
-
-        boolvec_t avail(m_alloc_per_page, true);
-        m_pages.resize(m_pages.size() + npages, nullptr);
-        m_offset_empty.resize(m_offset_empty.size() + npages, m_alloc_per_page);
-        m_offset_avail.resize(m_offset_avail.size() + npages, avail);
-
-        for(int i = 0; i < npages; ++i)
+        // any remainder of the current block is placed into the free-list
+        while(_arena.next &&
+              static_cast<size_t>(_arena.last - _arena.next) >= sizeof(Tp))
         {
-            char* _ptr = (char*) _space;
-            _ptr += (i * units::get_page_size());
-            m_pages[_num_pages + i] = (void*) _ptr;
+            deallocate(reinterpret_cast<Tp*>(_arena.next), 1);
+            _arena.next += sizeof(Tp);
         }
+
+        _arena.blocks.emplace_back(_space);
+        _arena.next = static_cast<char*>(_space);
+        _arena.last = _arena.next + _nbytes;
+        _arena.nbytes += _nbytes;
+        size_t _max_pages = max_pages_per_block;
+        _arena.npages     = std::min<size_t>(2 * _arena.npages, _max_pages);
     }
 
-    const uint16_t                 m_alloc_per_page = units::get_page_size() / sizeof(Tp);
-    mutable uint16_t               m_next_offset    = 0;
-    mutable size_t                 m_next_page      = 0;
-    mutable void*                  m_next_addr      = nullptr;
-    mutable voidvec_t              m_pages          = {};
-    mutable sizevec_t              m_offset_empty   = {};
-    mutable std::vector<boolvec_t> m_offset_avail   = {};
-    mutable voidvec_t              m_allocations    = {};
-};
+    template <typename Up>
+    friend class graph_allocator;
 
-#endif  // defined(TIMEMORY_GRAPH_ALLOCATOR)
+    std::shared_ptr<arena> m_arena;
+};
 
 //======================================================================================//
 
@@ -637,7 +626,8 @@ public:
 
     /// Inverse of take_out: inserts the given graph as previous sibling of
     /// indicated node by a move operation, that is, the given graph becomes
-    /// empty. Returns iterator to the top node.
+    /// empty. Returns iterator to the top node. The nodes are copied when the given
+    /// graph uses a different allocator, e.g. the blocks of another graph_allocator.
     template <typename IterT>
     inline IterT move_in(IterT, graph&);
 
@@ -738,6 +728,14 @@ public:
     /// Inverse of 'index': return the n-th child of the node at position.
     static sibling_iterator child(const iterator_base& position, unsigned int);
 
+    /// Return the child recorded via \ref set_child_hint for the node at position or
+    /// an iterator to nullptr if no hint exists or the hinted node is no longer a child
+    static sibling_iterator child_hint(const iterator_base& position);
+
+    /// Record the child of the node at position which is most likely to be looked
+    /// up next. This is only a hint and does not modify the structure of the graph
+    static void set_child_hint(const iterator_base& position, const iterator_base& child);
+
     /// Return iterator to the sibling indicated by index
     TIMEMORY_NODISCARD inline sibling_iterator sibling(const iterator_base& position,
                                                        unsigned int) const;
@@ -754,10 +752,24 @@ public:
             ar(cereal::make_nvp("node", *itr));
     }
 
+    /// Return the allocator used for the nodes
+    TIMEMORY_NODISCARD const AllocatorT& get_allocator() const { return m_alloc; }
+
 private:
     AllocatorT  m_alloc;
     inline void m_head_initialize();
     inline void m_copy(const graph<T, AllocatorT>& other);
+    // copy the nodes of other into this allocator when they are owned by another one
+    inline void m_adopt(graph<T, AllocatorT>& other);
+
+    // destroy every node and release the allocator memory in bulk, if supported
+    template <typename AllocT = AllocatorT>
+    inline auto m_bulk_clear(int) -> decltype(std::declval<AllocT&>().release(), bool());
+    template <typename AllocT = AllocatorT>
+    inline bool m_bulk_clear(long)
+    {
+        return false;
+    }
 };
 
 //======================================================================================//
@@ -783,12 +795,13 @@ graph<T, AllocatorT>::graph(const T& x)
 
 template <typename T, typename AllocatorT>
 graph<T, AllocatorT>::graph(graph<T, AllocatorT>&& x) noexcept
+: m_alloc(x.m_alloc)
 {
     m_head_initialize();
     if(x.head->next_sibling != x.feet)
     {  // move graph if non-empty only
         head->next_sibling                 = x.head->next_sibling;
-        feet->prev_sibling                 = x.head->prev_sibling;
+        feet->prev_sibling                 = x.feet->prev_sibling;
         x.head->next_sibling->prev_sibling = head;
         x.feet->prev_sibling->next_sibling = feet;
         x.head->next_sibling               = x.feet;
@@ -812,10 +825,10 @@ template <typename T, typename AllocatorT>
 graph<T, AllocatorT>::~graph()
 {
     clear();
-    m_alloc.destroy(head);
-    m_alloc.destroy(feet);
-    m_alloc.deallocate(head, 1);
-    m_alloc.deallocate(feet, 1);
+    // head and feet are not allocated from m_alloc so that the node memory
+    // can be released in bulk
+    delete head;
+    delete feet;
 }
 
 //--------------------------------------------------------------------------------------//
@@ -824,10 +837,8 @@ template <typename T, typename AllocatorT>
 void
 graph<T, AllocatorT>::m_head_initialize()
 {
-    head = m_alloc.allocate(1, nullptr);  // MSVC does not have default second argument
-    feet = m_alloc.allocate(1, nullptr);
-    m_alloc.construct(head, std::move(tgraph_node<T>{}));
-    m_alloc.construct(feet, std::move(tgraph_node<T>{}));
+    head = new graph_node{};
+    feet = new graph_node{};
 
     head->parent       = nullptr;
     head->first_child  = nullptr;
@@ -861,12 +872,19 @@ graph<T, AllocatorT>::operator=(graph<T, AllocatorT>&& x) noexcept
 {
     if(this != &x)
     {
-        head->next_sibling                 = x.head->next_sibling;
-        feet->prev_sibling                 = x.head->prev_sibling;
-        x.head->next_sibling->prev_sibling = head;
-        x.feet->prev_sibling->next_sibling = feet;
-        x.head->next_sibling               = x.feet;
-        x.feet->prev_sibling               = x.head;
+        // destroy the existing nodes while they are still owned by the current
+        // allocator, the nodes of x are owned by the allocator of x
+        clear();
+        m_alloc = x.m_alloc;
+        if(x.head->next_sibling != x.feet)
+        {
+            head->next_sibling                 = x.head->next_sibling;
+            feet->prev_sibling                 = x.feet->prev_sibling;
+            x.head->next_sibling->prev_sibling = head;
+            x.feet->prev_sibling->next_sibling = feet;
+            x.head->next_sibling               = x.feet;
+            x.feet->prev_sibling               = x.head;
+        }
     }
     return *this;
 }
@@ -910,11 +928,28 @@ graph<T, AllocatorT>::m_copy(const graph<T, AllocatorT>& other)
 
 //--------------------------------------------------------------------------------------//
 
+template <typename T, typename AllocatorT>
+void
+graph<T, AllocatorT>::m_adopt(graph<T, AllocatorT>& other)
+{
+    // the nodes of the other graph cannot be spliced in when they are owned by
+    // memory which the other graph may release in bulk
+    if(m_alloc == other.m_alloc || other.head->next_sibling == other.feet)
+        return;
+
+    graph _tmp{};
+    _tmp.m_alloc = m_alloc;
+    _tmp.m_copy(other);
+    other = std::move(_tmp);
+}
+
+//--------------------------------------------------------------------------------------//
+
 template <typename T, typename AllocatorT>
 void
 graph<T, AllocatorT>::clear()
 {
-    if(head)
+    if(head && head->next_sibling != feet && !m_bulk_clear(0))
     {
         while(head->next_sibling != feet)
             erase(pre_order_iterator(head->next_sibling));
@@ -923,6 +958,44 @@ graph<T, AllocatorT>::clear()
 
 //--------------------------------------------------------------------------------------//
 
+template <typename T, typename AllocatorT>
+template <typename AllocT>
+auto
+graph<T, AllocatorT>::m_bulk_clear(int)
+    -> decltype(std::declval<AllocT&>().release(), bool())
+{
+    // another graph may own nodes in the same memory
+    if(m_alloc.use_count() > 1)
+        return false;
+
+    // post-order traversal so that a node is destroyed after its children
+    graph_node* cur = head->next_sibling;
+    while(cur != feet)
+    {
+        while(cur->first_child)
+            cur = cur->first_child;
+        graph_node* _next   = cur->next_sibling;
+        graph_node* _parent = cur->parent;
+        m_alloc.destroy(cur);
+        if(_next)
+        {
+            cur = _next;
+        }
+        else
+        {
+            _parent->first_child = nullptr;
+            cur                  = _parent;
+        }
+    }
+
+    head->next_sibling = feet;
+    feet->prev_sibling = head;
+    m_alloc.release();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------//
+
 template <typename T, typename AllocatorT>
 void
 graph<T, AllocatorT>::erase_children(const iterator_base& it)
@@ -936,10 +1009,13 @@ graph<T, AllocatorT>::erase_children(const iterator_base& it)
     {
         while(cur->next_sibling && cur->next_sibling != feet)
             erase(pre_order_iterator(cur->next_sibling));
+        // return the first child to the allocator as well
+        erase(pre_order_iterator(cur));
     }
 
     it.node->first_child = nullptr;
     it.node->last_child  = nullptr;
+    it.node->child_hint  = nullptr;
 }
 
 //--------------------------------------------------------------------------------------//
@@ -976,6 +1052,9 @@ graph<T, AllocatorT>::erase(IterT it)
         cur->next_sibling->prev_sibling = cur->prev_sibling;
     }
 
+    if(cur->parent && cur->parent->child_hint == cur)
+        cur->parent->child_hint = nullptr;
+
     m_alloc.destroy(cur);
     m_alloc.deallocate(cur, 1);
     it.node = nullptr;
@@ -2019,6 +2098,8 @@ graph<T, AllocatorT>
 graph<T, AllocatorT>::move_out(iterator source)
 {
     graph ret;
+    // the node remains in the memory of this graph
+    ret.m_alloc = m_alloc;
 
     // Move source node into the 'ret' graph.
     ret.head->next_sibling = source.node;
@@ -2049,6 +2130,8 @@ graph<T, AllocatorT>::move_in(IterT loc, graph& other)
     if(other.head->next_sibling == other.feet)
         return loc;  // other graph is empty
 
+    m_adopt(other);
+
     graph_node* other_first_head = other.head->next_sibling;
     graph_node* other_last_head  = other.feet->prev_sibling;
 
@@ -2079,6 +2162,16 @@ graph<T, AllocatorT>::move_in(IterT loc, graph& other)
 
 //--------------------------------------------------------------------------------------//
 
+template <typename T, typename AllocatorT>
+template <typename IterT>
+IterT
+graph<T, AllocatorT>::move_in_below(IterT loc, graph& other)
+{
+    return move_in_as_nth_child(loc, number_of_children(loc), other);
+}
+
+//--------------------------------------------------------------------------------------//
+
 template <typename T, typename AllocatorT>
 template <typename IterT>
 IterT
@@ -2087,6 +2180,8 @@ graph<T, AllocatorT>::move_in_as_nth_child(IterT loc, size_t n, graph& other)
     if(other.head->next_sibling == other.feet)
         return loc;  // other graph is empty
 
+    m_adopt(other);
+
     graph_node* other_first_head = other.head->next_sibling;
     graph_node* other_last_head  = other.feet->prev_sibling;
 
@@ -2682,6 +2777,29 @@ graph<T, AllocatorT>::child(const iterator_base& it, unsigned int num)
     return tmp;
 }
 
+//--------------------------------------------------------------------------------------//
+
+template <typename T, typename AllocatorT>
+typename graph<T, AllocatorT>::sibling_iterator
+graph<T, AllocatorT>::child_hint(const iterator_base& it)
+{
+    graph_node* tmp = (it.node) ? it.node->child_hint : nullptr;
+    // the hinted node may have been moved to another parent
+    if(tmp && tmp->parent != it.node)
+        tmp = nullptr;
+    return tmp;
+}
+
+//--------------------------------------------------------------------------------------//
+
+template <typename T, typename AllocatorT>
+void
+graph<T, AllocatorT>::set_child_hint(const iterator_base& it, const iterator_base& child)
+{
+    if(it.node != nullptr)
+        it.node->child_hint = child.node;
+}
+
 //--------------------------------------------------------------------------------------//
 // Iterator base
 
@@ -33,11 +33,13 @@
 #include "timemory/storage/types.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 //--------------------------------------------------------------------------------------//
@@ -66,6 +68,53 @@ public:
     using pre_order_iterator = typename graph_t::pre_order_iterator;
     using sibling_iterator   = typename graph_t::sibling_iterator;
 
+    /// the number of attempts after which a read makes the modifications wait until it
+    /// completes
+    static constexpr size_t max_read_retries = 8;
+
+    /// \struct tim::graph_data::modify_guard
+    /// \brief Brackets a structural modification of the graph so that it never overlaps
+    /// a \ref read. Guards may be nested. The modification waits until the reads in
+    /// progress complete and the reads which start during the modification wait for it,
+    /// so a reader never sees a node which is being linked or released. A read which
+    /// could not start in \ref max_read_retries attempts makes the next modification
+    /// wait until it completes so that a reader is not starved by a thread which inserts
+    /// continuously.
+    struct modify_guard
+    {
+        explicit modify_guard(graph_data& _data)
+        : m_data(_data)
+        {
+            // a nested guard does not wait for a starving read since the read cannot
+            // start before the outer guard is released
+            if(m_data.m_writers.load() == 0)
+            {
+                while(m_data.m_starving.load())
+                    std::this_thread::yield();
+            }
+            // the readers check for a writer after they announce themselves so either
+            // the read sees this writer or this writer sees the read
+            ++m_data.m_writers;
+            ++m_data.m_epoch;
+            while(m_data.m_readers.load() > 0)
+                std::this_thread::yield();
+        }
+
+        ~modify_guard()
+        {
+            ++m_data.m_epoch;
+            --m_data.m_writers;
+        }
+
+        modify_guard(const modify_guard&) = delete;
+        modify_guard(modify_guard&&)      = delete;
+        modify_guard& operator=(const modify_guard&) = delete;
+        modify_guard& operator=(modify_guard&&) = delete;
+
+    private:
+        graph_data& m_data;
+    };
+
 public:
     // graph_data() = default;
 
@@ -80,7 +129,11 @@ public:
         m_dummies.insert({ m_depth, m_current });
     }
 
-    ~graph_data() { m_graph.clear(); }
+    ~graph_data()
+    {
+        modify_guard _guard{ *this };
+        m_graph.clear();
+    }
 
     // allow move and copy construct
     graph_data(this_type&&) = delete;
@@ -110,8 +163,37 @@ public:
     TIMEMORY_NODISCARD const_iterator begin() const { return m_graph.begin(); }
     TIMEMORY_NODISCARD const_iterator end() const { return m_graph.end(); }
 
+    TIMEMORY_NODISCARD uint64_t epoch() const { return m_epoch.load(); }
+
+    /// invokes the function with a const reference to the graph once no structural
+    /// modification is in progress. The modifications wait until the function returns.
+    /// Intended for reading the graph from a thread other than the one which owns it:
+    /// the topology seen by the function is consistent but the values of the nodes may
+    /// be mid-update. Returns the number of attempts.
+    template <typename FuncT>
+    size_t read(FuncT&& _func) const
+    {
+        for(size_t _n = 1;; ++_n)
+        {
+            if(_n > max_read_retries)
+                m_starving.store(true);
+            ++m_readers;
+            if(m_writers.load() == 0)
+            {
+                if(_n > max_read_retries)
+                    m_starving.store(false);
+                _func(m_graph);
+                --m_readers;
+                return _n;
+            }
+            --m_readers;
+            std::this_thread::yield();
+        }
+    }
+
     inline void clear()
     {
+        modify_guard _guard{ *this };
         m_graph.clear();
         m_has_head  = false;
         m_depth     = 0;
@@ -144,6 +226,7 @@ public:
 
         NodeT node(_id, NodeT::get_dummy(), _depth, threading::get_id(),
                    process::get_id(), true);
+        modify_guard _guard{ *this };
         m_depth     = _depth;
         m_sea_level = _depth;
         m_current   = m_graph.insert_after(m_head, node);
@@ -153,6 +236,7 @@ public:
 
     inline void reset()
     {
+        modify_guard _guard{ *this };
         m_graph.erase_children(m_head);
         m_depth   = 0;
         m_current = m_head;
@@ -211,17 +295,20 @@ public:
 
     inline iterator append_child(NodeT& node)
     {
+        modify_guard _guard{ *this };
         ++m_depth;
         return (m_current = m_graph.append_child(m_current, node));
     }
 
     inline iterator append_head(NodeT& node)
     {
+        modify_guard _guard{ *this };
         return m_graph.append_child(m_head, node);
     }
 
     inline iterator emplace_child(iterator _itr, NodeT& node)
     {
+        modify_guard _guard{ *this };
         return m_graph.append_child(_itr, node);
     }
 
@@ -243,8 +330,17 @@ private:
     iterator                         m_head    = nullptr;
     graph_data*                      m_master  = nullptr;
     std::multimap<int64_t, iterator> m_dummies = {};
+    std::atomic<uint64_t>            m_epoch{ 0 };
+    std::atomic<int64_t>             m_writers{ 0 };
+    mutable std::atomic<int64_t>     m_readers{ 0 };
+    mutable std::atomic<bool>        m_starving{ false };
 };
 //
 //--------------------------------------------------------------------------------------//
 //
+template <typename NodeT>
+constexpr size_t graph_data<NodeT>::max_read_retries;
+//
+//--------------------------------------------------------------------------------------//
+//
 }  // namespace tim
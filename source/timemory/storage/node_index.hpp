@@ -0,0 +1,222 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * \file timemory/storage/node_index.hpp
+ * \brief Flat open-addressing hash-table for locating graph nodes from their depth and
+ * hash
+ */
+
+#pragma once
+
+#include "timemory/macros/attributes.hpp"
+#include "timemory/macros/language.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::node_index
+/// \brief Open-addressing (linear probing) hash-table which maps the (depth, hash) pair
+/// of a graph node to a value (typically the graph iterator). The key and the value are
+/// stored together in a single contiguous array so a lookup or an insertion is a single
+/// probe sequence over adjacent memory instead of the two node-based hash-tables of
+/// a nested map. Entries are never erased individually: \ref erase_if rebuilds the
+/// table so no tombstones are required.
+///
+template <typename ValueT>
+class node_index
+{
+public:
+    using this_type  = node_index<ValueT>;
+    using key_type   = std::pair<int64_t, int64_t>;
+    using value_type = ValueT;
+    using size_type  = size_t;
+
+    struct entry_type
+    {
+        int64_t depth = empty_depth();
+        int64_t hash  = 0;
+        ValueT  value = {};
+
+        TIMEMORY_NODISCARD bool empty() const { return depth == empty_depth(); }
+    };
+
+    using table_type = std::vector<entry_type>;
+
+public:
+    node_index()                      = default;
+    ~node_index()                     = default;
+    node_index(const node_index&)     = default;
+    node_index(node_index&&) noexcept = default;
+    node_index& operator=(const node_index&) = default;
+    node_index& operator=(node_index&&) noexcept = default;
+
+    TIMEMORY_NODISCARD bool      empty() const { return m_size == 0; }
+    TIMEMORY_NODISCARD size_type size() const { return m_size; }
+    TIMEMORY_NODISCARD size_type capacity() const { return m_table.size(); }
+    TIMEMORY_NODISCARD size_type bytes() const
+    {
+        return m_table.capacity() * sizeof(typename table_type::value_type);
+    }
+
+    void clear()
+    {
+        m_table.clear();
+        m_size = 0;
+    }
+
+    void reserve(size_type _n)
+    {
+        size_type _cap = min_capacity();
+        while(_cap < 2 * _n)
+            _cap *= 2;
+        if(_cap > m_table.size())
+            rehash(_cap);
+    }
+
+    /// return a pointer to the value for the depth and hash or nullptr if not found
+    ValueT* find(int64_t _depth, int64_t _hash)
+    {
+        if(m_size == 0)
+            return nullptr;
+        auto& _entry = m_table[probe(_depth, _hash)];
+        return (_entry.empty()) ? nullptr : &_entry.value;
+    }
+
+    TIMEMORY_NODISCARD const ValueT* find(int64_t _depth, int64_t _hash) const
+    {
+        return const_cast<this_type*>(this)->find(_depth, _hash);
+    }
+
+    /// locate the slot for the depth and hash, inserting a default value if not found.
+    /// The second value is true if an insertion took place
+    std::pair<ValueT*, bool> emplace(int64_t _depth, int64_t _hash)
+    {
+        if(2 * (m_size + 1) > m_table.size())
+            rehash((m_table.empty()) ? min_capacity() : 2 * m_table.size());
+        auto& _entry = m_table[probe(_depth, _hash)];
+        if(!_entry.empty())
+            return { &_entry.value, false };
+        _entry.depth = _depth;
+        _entry.hash  = _hash;
+        ++m_size;
+        return { &_entry.value, true };
+    }
+
+    /// assign the value for the depth and hash
+    ValueT& insert(int64_t _depth, int64_t _hash, const ValueT& _value)
+    {
+        auto* _ptr = emplace(_depth, _hash).first;
+        *_ptr      = _value;
+        return *_ptr;
+    }
+
+    /// remove all the entries which satisfy the predicate
+    template <typename FuncT>
+    void erase_if(FuncT&& _pred)
+    {
+        table_type _existing{};
+        std::swap(_existing, m_table);
+        m_table.resize(_existing.size());
+        m_size = 0;
+        for(auto& itr : _existing)
+        {
+            if(!itr.empty() && !_pred(itr.depth, itr.hash, itr.value))
+                insert(itr.depth, itr.hash, itr.value);
+        }
+    }
+
+    /// invoke the function with the depth, hash, and value of every entry
+    template <typename FuncT>
+    void for_each(FuncT&& _func) const
+    {
+        for(const auto& itr : m_table)
+        {
+            if(!itr.empty())
+                _func(itr.depth, itr.hash, itr.value);
+        }
+    }
+
+private:
+    static constexpr size_type min_capacity() { return 64; }
+
+    static constexpr int64_t empty_depth() { return std::numeric_limits<int64_t>::min(); }
+
+    static size_t mix(int64_t _depth, int64_t _hash)
+    {
+        // combine the depth and hash and apply the splitmix64 finalizer
+        auto _v = static_cast<uint64_t>(_hash) ^
+                  (static_cast<uint64_t>(_depth) * 0x9e3779b97f4a7c15ULL);
+        _v = (_v ^ (_v >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        _v = (_v ^ (_v >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<size_t>(_v ^ (_v >> 31));
+    }
+
+    // return the index of the matching entry or the first empty entry
+    size_type probe(int64_t _depth, int64_t _hash) const
+    {
+        auto _mask = m_table.size() - 1;
+        auto _idx  = mix(_depth, _hash) & _mask;
+        while(true)
+        {
+            const auto& _entry = m_table[_idx];
+            if(_entry.empty() || (_entry.hash == _hash && _entry.depth == _depth))
+                return _idx;
+            _idx = (_idx + 1) & _mask;
+        }
+    }
+
+    void rehash(size_type _cap)
+    {
+        table_type _existing(_cap);
+        std::swap(_existing, m_table);
+        m_size = 0;
+        for(auto& itr : _existing)
+        {
+            if(!itr.empty())
+            {
+                auto& _entry = m_table[probe(itr.depth, itr.hash)];
+                _entry       = std::move(itr);
+                ++m_size;
+            }
+        }
+    }
+
+private:
+    size_type  m_size  = 0;
+    table_type m_table = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace tim
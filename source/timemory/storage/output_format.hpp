@@ -0,0 +1,100 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * \file timemory/storage/output_format.hpp
+ * \brief Formatting shared by the writers of the binary output, the event trace and
+ * their JSON conversions
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace tim
+{
+namespace output_format
+{
+//
+/// escapes the characters of the string which are not allowed in a JSON string
+inline std::string
+escape(const std::string& _v)
+{
+    std::string _ret{};
+    _ret.reserve(_v.length());
+    for(unsigned char c : _v)
+    {
+        switch(c)
+        {
+            case '"': _ret += "\\\""; break;
+            case '\\': _ret += "\\\\"; break;
+            case '\n': _ret += "\\n"; break;
+            case '\t': _ret += "\\t"; break;
+            case '\r': _ret += "\\r"; break;
+            default:
+            {
+                if(c < 0x20)
+                {
+                    char _buff[8];
+                    snprintf(_buff, sizeof(_buff), "\\u%04x", c);
+                    _ret += _buff;
+                }
+                else
+                {
+                    _ret += static_cast<char>(c);
+                }
+            }
+        }
+    }
+    return _ret;
+}
+//
+/// JSON does not support nan or inf
+inline std::string
+number(double _v)
+{
+    char _buff[32];
+    snprintf(_buff, sizeof(_buff), "%.17g", (std::isfinite(_v)) ? _v : 0.0);
+    return _buff;
+}
+//
+/// the display unit of components with a single value, empty otherwise
+template <typename Tp>
+auto
+get_unit(int) -> decltype(std::string{ Tp::get_display_unit() })
+{
+    return std::string{ Tp::get_display_unit() };
+}
+//
+template <typename Tp>
+std::string
+get_unit(long)
+{
+    return std::string{};
+}
+//
+}  // namespace output_format
+}  // namespace tim
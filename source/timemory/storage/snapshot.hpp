@@ -0,0 +1,305 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * \file timemory/storage/snapshot.hpp
+ * \brief Struct-of-arrays copy of the call-graph of a thread for components with a
+ * scalar or std::array value type
+ */
+
+#pragma once
+
+#include "timemory/macros/attributes.hpp"
+#include "timemory/macros/language.hpp"
+#include "timemory/storage/node.hpp"
+#include "timemory/tpls/cereal/cereal.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+namespace concepts
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::concepts::is_snapshot_value
+/// \brief concept that specifies that a value type can be copied into a
+/// \ref tim::storage_snapshot, i.e. it is arithmetic or a std::array of an arithmetic
+/// type
+///
+template <typename Tp>
+struct is_snapshot_value : std::is_arithmetic<Tp>
+{};
+//
+template <typename Tp, size_t N>
+struct is_snapshot_value<std::array<Tp, N>> : std::is_arithmetic<Tp>
+{};
+//
+}  // namespace concepts
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::storage_snapshot
+/// \brief Read-only copy of the call-graph of a thread which is made by
+/// \ref tim::impl::storage::snapshot while the thread continues to insert. The fields
+/// of every node (value, accumulation, laps, statistics, etc.) are copied into separate
+/// arrays indexed by the node index and the topology into parent / first-child /
+/// next-sibling index arrays. The nodes are stored in pre-order.
+///
+template <typename Tp>
+class storage_snapshot
+{
+public:
+    using this_type      = storage_snapshot<Tp>;
+    using component_type = Tp;
+    using value_type     = typename Tp::value_type;
+    using stats_type     = typename node::data<Tp>::stats_type;
+    using index_type     = int32_t;
+    using size_type      = size_t;
+
+    static_assert(concepts::is_snapshot_value<value_type>::value,
+                  "storage_snapshot requires an arithmetic or std::array value type");
+
+    static constexpr index_type npos = -1;
+
+public:
+    storage_snapshot()                            = default;
+    ~storage_snapshot()                           = default;
+    storage_snapshot(const storage_snapshot&)     = default;
+    storage_snapshot(storage_snapshot&&) noexcept = default;
+    storage_snapshot& operator=(const storage_snapshot&) = default;
+    storage_snapshot& operator=(storage_snapshot&&) noexcept = default;
+
+    /// construct from a \ref tim::graph of \ref tim::node::graph entries
+    template <typename GraphT>
+    explicit storage_snapshot(const GraphT& _graph)
+    {
+        assign(_graph);
+    }
+
+    /// replace the contents with the nodes of a \ref tim::graph in pre-order
+    template <typename GraphT>
+    void assign(const GraphT& _graph);
+
+    /// append a node as the last child of parent (npos for a top-level node)
+    index_type emplace(index_type _parent, const node::graph<Tp>& _node);
+
+    /// reconstruct the component of the node at the given index
+    TIMEMORY_NODISCARD Tp get(index_type _idx) const;
+
+    void reserve(size_type _n);
+    void clear();
+
+    TIMEMORY_NODISCARD size_type size() const { return m_id.size(); }
+    TIMEMORY_NODISCARD bool      empty() const { return m_id.empty(); }
+
+    // topology
+    TIMEMORY_NODISCARD const auto& parent() const { return m_parent; }
+    TIMEMORY_NODISCARD const auto& first_child() const { return m_first_child; }
+    TIMEMORY_NODISCARD const auto& next_sibling() const { return m_next_sibling; }
+
+    // node fields
+    TIMEMORY_NODISCARD const auto& id() const { return m_id; }
+    TIMEMORY_NODISCARD const auto& depth() const { return m_depth; }
+    TIMEMORY_NODISCARD const auto& tid() const { return m_tid; }
+    TIMEMORY_NODISCARD const auto& is_dummy() const { return m_dummy; }
+    TIMEMORY_NODISCARD const auto& value() const { return m_value; }
+    TIMEMORY_NODISCARD const auto& accum() const { return m_accum; }
+    TIMEMORY_NODISCARD const auto& laps() const { return m_laps; }
+    TIMEMORY_NODISCARD const auto& stats() const { return m_stats; }
+
+    /// invoke the function with the index of each child of parent
+    template <typename FuncT>
+    void for_each_child(index_type _parent, FuncT&& _func) const
+    {
+        for(auto i = m_first_child.at(_parent); i != npos; i = m_next_sibling.at(i))
+            _func(i);
+    }
+
+    template <typename Archive>
+    void save(Archive& ar, const unsigned int) const;
+
+private:
+    std::vector<index_type> m_parent       = {};
+    std::vector<index_type> m_first_child  = {};
+    std::vector<index_type> m_last_child   = {};
+    std::vector<index_type> m_next_sibling = {};
+    std::vector<uint64_t>   m_id           = {};
+    std::vector<int64_t>    m_depth        = {};
+    std::vector<uint16_t>   m_tid          = {};
+    std::vector<uint8_t>    m_dummy        = {};
+    std::vector<value_type> m_value        = {};
+    std::vector<value_type> m_accum        = {};
+    std::vector<int64_t>    m_laps         = {};
+    std::vector<stats_type> m_stats        = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+constexpr typename storage_snapshot<Tp>::index_type storage_snapshot<Tp>::npos;
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+template <typename GraphT>
+void
+storage_snapshot<Tp>::assign(const GraphT& _graph)
+{
+    using sibling_iterator = typename GraphT::sibling_iterator;
+    using level_type       = std::tuple<sibling_iterator, sibling_iterator, index_type>;
+
+    clear();
+    reserve(_graph.size());
+
+    // the next sibling to copy and the end of the siblings at every level of the path
+    // to the current node, so the depth of the graph does not use the call stack
+    std::vector<level_type> _path{};
+    _path.emplace_back(_graph.begin(), _graph.end(), npos);
+    while(!_path.empty())
+    {
+        auto& _level = _path.back();
+        if(std::get<0>(_level) == std::get<1>(_level))
+        {
+            _path.pop_back();
+            continue;
+        }
+        sibling_iterator _itr = std::get<0>(_level)++;
+        auto             _idx = emplace(std::get<2>(_level), *_itr);
+        _path.emplace_back(_graph.begin(_itr), _graph.end(_itr), _idx);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+typename storage_snapshot<Tp>::index_type
+storage_snapshot<Tp>::emplace(index_type _parent, const node::graph<Tp>& _node)
+{
+    auto _idx = static_cast<index_type>(m_id.size());
+
+    m_parent.emplace_back(_parent);
+    m_first_child.emplace_back(npos);
+    m_last_child.emplace_back(npos);
+    m_next_sibling.emplace_back(npos);
+    m_id.emplace_back(_node.id());
+    m_depth.emplace_back(_node.depth());
+    m_tid.emplace_back(_node.tid());
+    m_dummy.emplace_back(_node.is_dummy() ? 1 : 0);
+    m_value.emplace_back(_node.obj().get_value());
+    m_accum.emplace_back(_node.obj().get_accum());
+    m_laps.emplace_back(_node.obj().get_laps());
+    m_stats.emplace_back(_node.stats());
+
+    if(_parent != npos)
+    {
+        auto& _last = m_last_child.at(_parent);
+        if(_last == npos)
+            m_first_child.at(_parent) = _idx;
+        else
+            m_next_sibling.at(_last) = _idx;
+        _last = _idx;
+    }
+
+    return _idx;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+Tp
+storage_snapshot<Tp>::get(index_type _idx) const
+{
+    Tp _obj{};
+    _obj.set_value(m_value.at(_idx));
+    _obj.set_accum(m_accum.at(_idx));
+    _obj.set_laps(m_laps.at(_idx));
+    return _obj;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+void
+storage_snapshot<Tp>::reserve(size_type _n)
+{
+    m_parent.reserve(_n);
+    m_first_child.reserve(_n);
+    m_last_child.reserve(_n);
+    m_next_sibling.reserve(_n);
+    m_id.reserve(_n);
+    m_depth.reserve(_n);
+    m_tid.reserve(_n);
+    m_dummy.reserve(_n);
+    m_value.reserve(_n);
+    m_accum.reserve(_n);
+    m_laps.reserve(_n);
+    m_stats.reserve(_n);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+void
+storage_snapshot<Tp>::clear()
+{
+    m_parent.clear();
+    m_first_child.clear();
+    m_last_child.clear();
+    m_next_sibling.clear();
+    m_id.clear();
+    m_depth.clear();
+    m_tid.clear();
+    m_dummy.clear();
+    m_value.clear();
+    m_accum.clear();
+    m_laps.clear();
+    m_stats.clear();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+template <typename Archive>
+void
+storage_snapshot<Tp>::save(Archive& ar, const unsigned int) const
+{
+    ar(cereal::make_nvp("parent", m_parent), cereal::make_nvp("id", m_id),
+       cereal::make_nvp("depth", m_depth), cereal::make_nvp("tid", m_tid),
+       cereal::make_nvp("dummy", m_dummy), cereal::make_nvp("value", m_value),
+       cereal::make_nvp("accum", m_accum), cereal::make_nvp("laps", m_laps),
+       cereal::make_nvp("stats", m_stats));
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace tim
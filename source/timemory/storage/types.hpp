@@ -206,7 +206,7 @@ class tgraph_node;
 template <typename Tp>
 class graph_allocator;
 //
-template <typename T, typename AllocatorT = std::allocator<tgraph_node<T>>>
+template <typename T, typename AllocatorT = graph_allocator<tgraph_node<T>>>
 class graph;
 //
 //--------------------------------------------------------------------------------------//
@@ -0,0 +1,179 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * \file timemory/storage/usage.hpp
+ * \brief Accounting of the memory used by the storage of a component on one thread
+ */
+
+#pragma once
+
+#include "timemory/hash/concurrent_map.hpp"
+#include "timemory/macros/attributes.hpp"
+#include "timemory/tpls/cereal/cereal.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::storage_usage
+/// \brief The number of heap bytes held by the storage of a component on one thread,
+/// broken down by data structure. The container sizes are estimated from their
+/// capacity, bucket count and node size and any heap memory owned by the component
+/// instances themselves is not included. The hash-id and hash-alias maps are shared
+/// by all the components and threads.
+///
+struct storage_usage
+{
+    int64_t  tid          = -1;  ///< thread index of the storage
+    uint64_t graph        = 0;   ///< call-graph nodes, including the retired workers
+    uint64_t node_ids     = 0;   ///< the (depth, hash) node index of the insert paths
+    uint64_t hash_ids     = 0;   ///< the hash to label map
+    uint64_t hash_aliases = 0;   ///< the hash to hash alias map
+    uint64_t stack        = 0;   ///< the set of the running components
+    uint64_t samples      = 0;   ///< the timeline samples
+
+    TIMEMORY_NODISCARD uint64_t total() const
+    {
+        return graph + node_ids + hash_ids + hash_aliases + stack + samples;
+    }
+
+    /// the entries keyed by the name of the data structure
+    TIMEMORY_NODISCARD std::map<std::string, uint64_t> entries() const
+    {
+        return { { "graph", graph },          { "node_ids", node_ids },
+                 { "hash_ids", hash_ids },    { "hash_aliases", hash_aliases },
+                 { "stack", stack },          { "samples", samples },
+                 { "total", total() } };
+    }
+
+    storage_usage& operator+=(const storage_usage& rhs)
+    {
+        graph += rhs.graph;
+        node_ids += rhs.node_ids;
+        hash_ids += rhs.hash_ids;
+        hash_aliases += rhs.hash_aliases;
+        stack += rhs.stack;
+        samples += rhs.samples;
+        return *this;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar, const unsigned int)
+    {
+        ar(cereal::make_nvp("tid", tid), cereal::make_nvp("graph", graph),
+           cereal::make_nvp("node_ids", node_ids), cereal::make_nvp("hash_ids", hash_ids),
+           cereal::make_nvp("hash_aliases", hash_aliases),
+           cereal::make_nvp("stack", stack), cereal::make_nvp("samples", samples));
+    }
+
+    /// heap bytes of a string which exceeds the small-string buffer
+    static uint64_t get_bytes(const std::string& _v)
+    {
+        static const auto _sso = std::string{}.capacity();
+        return (_v.capacity() > _sso) ? (_v.capacity() + 1) : 0;
+    }
+
+    /// values which do not own heap memory
+    template <typename Tp>
+    static uint64_t get_bytes(const Tp&)
+    {
+        return 0;
+    }
+
+    template <typename Tp, typename AllocT>
+    static uint64_t get_bytes(const std::vector<Tp, AllocT>& _v)
+    {
+        uint64_t _n = _v.capacity() * sizeof(Tp);
+        for(const auto& itr : _v)
+            _n += get_bytes(itr);
+        return _n;
+    }
+
+    template <typename KeyT, typename... Args>
+    static uint64_t get_bytes(const std::unordered_set<KeyT, Args...>& _v)
+    {
+        return _v.bucket_count() * sizeof(void*) +
+               _v.size() * (sizeof(void*) + sizeof(KeyT));
+    }
+
+    template <typename KeyT, typename MappedT, typename... Args>
+    static uint64_t get_bytes(const std::unordered_map<KeyT, MappedT, Args...>& _v)
+    {
+        using value_type = typename std::unordered_map<KeyT, MappedT, Args...>::value_type;
+        uint64_t _n      = _v.bucket_count() * sizeof(void*) +
+                      _v.size() * (sizeof(void*) + sizeof(value_type));
+        for(const auto& itr : _v)
+            _n += get_bytes(itr.second);
+        return _n;
+    }
+
+    template <typename KeyT, typename MappedT>
+    static uint64_t get_bytes(const concurrent_hash_map<KeyT, MappedT>& _v)
+    {
+        uint64_t _n = _v.bytes();
+        _v.for_each([&_n](const auto& itr) { _n += get_bytes(itr.second); });
+        return _n;
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::storage_usage_counters
+/// \brief The heap bytes of the data structures of the storage which are only modified
+/// by the thread which owns the storage. That thread stores the bytes after it modifies
+/// a data structure so the other threads read these values instead of the containers
+///
+struct storage_usage_counters
+{
+    std::atomic<uint64_t> graph{ 0 };
+    std::atomic<uint64_t> node_ids{ 0 };
+    std::atomic<uint64_t> stack{ 0 };
+    std::atomic<uint64_t> samples{ 0 };
+
+    static void store(std::atomic<uint64_t>& _v, uint64_t _n)
+    {
+        _v.store(_n, std::memory_order_relaxed);
+    }
+
+    static uint64_t load(const std::atomic<uint64_t>& _v)
+    {
+        return _v.load(std::memory_order_relaxed);
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace tim
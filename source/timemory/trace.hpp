@@ -265,6 +265,77 @@ private:
 //
 //--------------------------------------------------------------------------------------//
 //
+/// \struct tim::trace::throttle
+/// \brief The per-function state of the throttling of instrumented functions. One in
+/// \ref period calls is measured: a period of zero is a function which is never
+/// measured again (the fixed mode) and, in the adaptive mode, the period is updated
+/// after every window of measured calls (see \ref update).
+///
+/// \code{.cpp}
+/// if(!_throttle.sample())
+///     return;
+/// \endcode
+struct throttle
+{
+    struct config
+    {
+        uint64_t value      = 10000;  // runtime (ns) below which a function is cheap
+        double   budget     = 0.02;   // target fraction of the runtime of a thread
+        uint32_t max_period = 1024;
+    };
+
+    uint32_t period    = 1;
+    uint32_t countdown = 1;
+
+    /// whether the function is not measured on every call
+    bool is_throttled() const { return period != 1; }
+
+    /// returns whether this call should be measured
+    bool sample()
+    {
+        if(period == 0 || --countdown > 0)
+            return false;
+        countdown = period;
+        return true;
+    }
+
+    /// never measure the function again
+    void disable() { period = 0; }
+
+    /// measure every call again
+    void reset()
+    {
+        period    = 1;
+        countdown = 1;
+    }
+
+    /// update the period from the average runtime (ns) of the measured calls of the
+    /// function and the fraction of the runtime of the thread spent in the
+    /// instrumentation. The period doubles while the function is cheap or the
+    /// instrumentation is over the budget and it is reset when the runtime of the
+    /// function has risen above the throttle value and the instrumentation is well
+    /// within the budget. Returns the previous period
+    uint32_t update(const config& _cfg, uint64_t _runtime, double _overhead)
+    {
+        auto _prev = period;
+        if(_prev == 0)
+            return _prev;
+        if(_runtime < _cfg.value || _overhead > _cfg.budget)
+        {
+            period = (2 * period < _cfg.max_period) ? (2 * period) : _cfg.max_period;
+            period = (period > 0) ? period : 1;
+        }
+        else if(_overhead < 0.5 * _cfg.budget)
+        {
+            reset();
+        }
+        countdown = (countdown < period) ? countdown : period;
+        return _prev;
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
 }  // namespace trace
 }  // namespace tim
 
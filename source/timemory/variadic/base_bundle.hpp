@@ -270,6 +270,10 @@ public:
         compute_width(_key);
     }
 
+    /// re-key with the hash of a label which is already registered, e.g. when a bundle
+    /// is reused for a different label. The output width is not updated
+    void rekey(hash_value_type _hash) { m_hash = _hash; }
+
 protected:
     using ctor_params_t = std::tuple<hash_value_type, bool, scope::config>;
 
@@ -233,6 +233,13 @@ public:
     data_type& data();
     /// returns a const reference to the underlying tuple of components
     const data_type& data() const;
+    /// re-key with the hash of a registered label and update the prefix of the
+    /// components which store it, e.g. when a stopped bundle is reused for another label
+    void rekey(hash_value_type _hash)
+    {
+        bundle_type::rekey(_hash);
+        set_prefix(_hash);
+    }
 
     using bundle_type::get_prefix;
     using bundle_type::get_scope;
@@ -65,6 +65,7 @@ TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, component::kernel_mode_time, false_
 #include "timemory/timemory.hpp"
 #include "timemory/trace.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <chrono>
@@ -94,9 +95,12 @@ using namespace tim::component;
 
 struct main_gotcha;
 struct pthread_gotcha;
-static int64_t primary_tidx   = 0;
-static size_t  throttle_count = 1000;
-static size_t  throttle_value = 10000;
+static int64_t                      primary_tidx      = 0;
+static size_t                       throttle_count    = 1000;
+static size_t                       throttle_value    = 10000;
+static size_t                       throttle_window   = 100;
+static bool                         adaptive_throttle = false;
+static tim::trace::throttle::config throttle_config   = {};
 
 #if !defined(TIMEMORY_USE_GOTCHA)
 TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, main_gotcha, false_type)
@@ -106,7 +110,7 @@ TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, pthread_gotcha, false_type)
 template <typename Tp>
 using uomap_t     = std::unordered_map<const void*, std::unordered_map<const void*, Tp>>;
 using trace_set_t = tim::available_list_t;
-using throttle_map_t = uomap_t<bool>;
+using throttle_map_t = uomap_t<tim::trace::throttle>;
 using overhead_map_t = uomap_t<std::tuple<size_t, monotonic_clock, size_t>>;
 using label_map_t    = uomap_t<size_t>;
 using trace_vec_t =
@@ -139,6 +143,8 @@ get_overhead() TIMEMORY_INTERNAL_NO_INSTRUMENT;
 static auto&
 get_throttle() TIMEMORY_INTERNAL_NO_INSTRUMENT;
 static auto&
+get_throttle_stats() TIMEMORY_INTERNAL_NO_INSTRUMENT;
+static auto&
 get_trace_vec() TIMEMORY_INTERNAL_NO_INSTRUMENT;
 static unsigned long
 get_trace_size() TIMEMORY_INTERNAL_NO_INSTRUMENT;
@@ -263,6 +269,24 @@ get_throttle()
 
 //--------------------------------------------------------------------------------------//
 
+// the instrumentation time of the thread since its first instrumented call and the
+// approximate number of calls which were not measured in the adaptive mode
+struct throttle_stats
+{
+    int64_t  begin      = wall_clock::record();
+    int64_t  instr      = 0;
+    uint64_t unmeasured = 0;
+};
+
+static auto&
+get_throttle_stats()
+{
+    static thread_local throttle_stats _instance{};
+    return _instance;
+}
+
+//--------------------------------------------------------------------------------------//
+
 static auto&
 get_trace_vec()
 {
@@ -390,6 +414,16 @@ initialize(const char* _exe_name)
         tim::get_env(TIMEMORY_SETTINGS_KEY("THROTTLE_COUNT"), throttle_count);
     throttle_value =
         tim::get_env(TIMEMORY_SETTINGS_KEY("THROTTLE_VALUE"), throttle_value);
+    adaptive_throttle =
+        tim::get_env(TIMEMORY_SETTINGS_KEY("ADAPTIVE_THROTTLE"), adaptive_throttle);
+    throttle_window       = std::max<size_t>(std::min(throttle_count, throttle_window), 1);
+    throttle_config.value = throttle_value;
+    throttle_config.budget =
+        tim::get_env(TIMEMORY_SETTINGS_KEY("THROTTLE_BUDGET"), throttle_config.budget);
+    throttle_config.max_period = std::min<size_t>(
+        tim::get_env<size_t>(TIMEMORY_SETTINGS_KEY("THROTTLE_MAX_PERIOD"),
+                             throttle_config.max_period),
+        std::numeric_limits<uint32_t>::max());
 
     // output path
     if(tim::get_env<std::string>(TIMEMORY_SETTINGS_KEY("OUTPUT_PATH"), "").empty())
@@ -485,6 +519,22 @@ finalize()
     get_overhead() = nullptr;
 
     // clean up throttle map
+    if(get_throttle() && adaptive_throttle)
+    {
+        size_t _n = 0;
+        for(const auto& sitr : *get_throttle())
+        {
+            for(const auto& fitr : sitr.second)
+                _n += (fitr.second.is_throttled()) ? 1 : 0;
+        }
+        if(_n > 0)
+        {
+            printf("[pid=%i][tid=%i]> timemory-compiler-instrument: adaptive throttling "
+                   "of %lu functions, ~%lu calls were not measured\n",
+                   (int) tim::process::get_id(), (int) tim::threading::get_id(),
+                   (unsigned long) _n, (unsigned long) get_throttle_stats().unmeasured);
+        }
+    }
     if(get_throttle())
         get_throttle()->clear();
     delete get_throttle();
@@ -549,18 +599,25 @@ extern "C"
                 tim::operation::decode<TIMEMORY_API>{}(_label).substr(0, 120).c_str());
         }
 
-        const auto& _overhead = get_overhead();
-        const auto& _throttle = get_throttle();
-        if((*_throttle)[CALL_SITE][this_fn])
+        const auto& _overhead  = get_overhead();
+        const auto& _throttle  = get_throttle();
+        auto&       _this_over = (*_overhead)[CALL_SITE][this_fn];
+        // recursive calls within a measured call are always measured
+        if(std::get<0>(_this_over) == 0 && !(*_throttle)[CALL_SITE][this_fn].sample())
             return;
 
+        int64_t _beg = (adaptive_throttle) ? wall_clock::record() : 0;
         _trace_vec->emplace_back(
             std::make_tuple(this_fn, call_site, std::make_unique<trace_set_t>(_label)));
         std::get<2>(_trace_vec->back())->start();
 
-        auto& _this_over = (*_overhead)[CALL_SITE][this_fn];
-        if(std::get<0>(_this_over) == 0)
+        // the adaptive mode times each outermost call. The fixed mode times the whole
+        // window of throttle_count calls, i.e. the clock is started by the first call
+        if(std::get<0>(_this_over)++ == 0 &&
+           (adaptive_throttle || std::get<2>(_this_over) == 0))
             std::get<1>(_this_over).start();
+        if(_beg > 0)
+            get_throttle_stats().instr += wall_clock::record() - _beg;
 
         tim::consume_parameters(call_site, null_site);
     }
@@ -599,14 +656,15 @@ extern "C"
         const auto& _overhead = get_overhead();
         const auto& _throttle = get_throttle();
 
-        if((_throttle != nullptr) && (*_throttle)[CALL_SITE][this_fn])
+        if(!_overhead || !_throttle || _trace_vec->empty())
             return;
 
-        if(_trace_vec->empty())
+        // if the depth is zero, the matching call was not measured
+        auto& _this_over = (*_overhead)[CALL_SITE][this_fn];
+        if(std::get<0>(_this_over) == 0)
             return;
 
-        if(_overhead)
-            --(std::get<0>((*_overhead)[CALL_SITE][this_fn]));
+        int64_t _beg = (adaptive_throttle) ? wall_clock::record() : 0;
 
         std::get<2>(_trace_vec->back())->stop();
         _trace_vec->pop_back();
@@ -617,18 +675,52 @@ extern "C"
             return;
         }
 
-        auto& _this_over = (*_overhead)[CALL_SITE][this_fn];
-        auto  _count     = ++(std::get<2>(_this_over));
-        if(_count % throttle_count == 0)
+        auto& _mono = std::get<1>(_this_over);
+        if(--std::get<0>(_this_over) > 0)
+            return;
+        if(adaptive_throttle)
+            _mono.stop();
+
+        auto& _this_throttle = (*_throttle)[CALL_SITE][this_fn];
+        auto  _count         = ++(std::get<2>(_this_over));
+        if(adaptive_throttle && _count >= throttle_window)
+        {
+            auto& _stats = get_throttle_stats();
+            auto  _now   = wall_clock::record();
+            _stats.instr += _now - _beg;
+            auto   _elapsed  = _now - _stats.begin;
+            double _fraction = (_elapsed > 0) ? (_stats.instr / (double) _elapsed) : 0.;
+            auto   _prev     = _this_throttle.update(
+                throttle_config, _mono.get_accum() / _count, _fraction);
+            _stats.unmeasured += _count * (_prev - 1);
+            if(get_debug() && _prev != _this_throttle.period)
+            {
+                fprintf(stderr,
+                        "[%i][%i][timemory-compiler-inst]> measuring one in %u calls "
+                        "to %s\n",
+                        (int) tim::process::get_id(), (int) tim::threading::get_id(),
+                        _this_throttle.period,
+                        tim::operation::decode<TIMEMORY_API>{}(
+                            tim::get_hash_identifier(get_label(this_fn, call_site)))
+                            .substr(0, 120)
+                            .c_str());
+            }
+            _mono.reset();
+            std::get<2>(_this_over) = 0;
+        }
+        else if(!adaptive_throttle && _count >= throttle_count)
         {
-            auto& _mono = std::get<1>(_this_over);
             _mono.stop();
             auto _accum = _mono.get_accum() / _count;
             if(_accum < throttle_value)
-                (*_throttle)[CALL_SITE][this_fn] = true;
+                _this_throttle.disable();
             _mono.reset();
             std::get<2>(_this_over) = 0;
         }
+        else if(_beg > 0)
+        {
+            get_throttle_stats().instr += wall_clock::record() - _beg;
+        }
 
         tim::consume_parameters(call_site, null_site);
     }
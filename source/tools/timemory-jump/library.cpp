@@ -62,6 +62,14 @@ public:
     void (*timemory_push_region_jump)(const char*);  // NOLINT
     void (*timemory_pop_region_jump)(const char*);   // NOLINT
 
+    uint64_t (*timemory_register_region_jump)(const char*);                     // NOLINT
+    uint64_t (*timemory_register_region_types_jump)(const char*, const char*);  // NOLINT
+    void (*timemory_push_region_handle_jump)(uint64_t);                         // NOLINT
+    void (*timemory_pop_region_handle_jump)(uint64_t);                          // NOLINT
+
+    void (*timemory_begin_records_jump)(int, const char**, uint64_t*);  // NOLINT
+    void (*timemory_end_records_jump)(int, const uint64_t*);            // NOLINT
+
     void (*timemory_add_hash_id_jump)(uint64_t, const char*);          // NOLINT
     void (*timemory_push_trace_jump)(const char*);                     // NOLINT
     void (*timemory_pop_trace_jump)(const char*);                      // NOLINT
@@ -92,6 +100,24 @@ public:
 
         DLSYM_JUMP_FUNCTION(timemory_pop_region_jump, libhandle, "timemory_pop_region");
 
+        DLSYM_JUMP_FUNCTION(timemory_register_region_jump, libhandle,
+                            "timemory_register_region");
+
+        DLSYM_JUMP_FUNCTION(timemory_register_region_types_jump, libhandle,
+                            "timemory_register_region_types");
+
+        DLSYM_JUMP_FUNCTION(timemory_push_region_handle_jump, libhandle,
+                            "timemory_push_region_handle");
+
+        DLSYM_JUMP_FUNCTION(timemory_pop_region_handle_jump, libhandle,
+                            "timemory_pop_region_handle");
+
+        DLSYM_JUMP_FUNCTION(timemory_begin_records_jump, libhandle,
+                            "timemory_begin_records");
+
+        DLSYM_JUMP_FUNCTION(timemory_end_records_jump, libhandle,
+                            "timemory_end_records");
+
         DLSYM_JUMP_FUNCTION(timemory_add_hash_id_jump, libhandle, "timemory_add_hash_id");
 
         DLSYM_JUMP_FUNCTION(timemory_push_trace_jump, libhandle, "timemory_push_trace");
@@ -158,6 +184,36 @@ extern "C"
         (*get_jump()->timemory_pop_region_jump)(name);
     }
 
+    uint64_t timemory_register_region(const char* name)
+    {
+        return (*get_jump()->timemory_register_region_jump)(name);
+    }
+
+    uint64_t timemory_register_region_types(const char* name, const char* types)
+    {
+        return (*get_jump()->timemory_register_region_types_jump)(name, types);
+    }
+
+    void timemory_push_region_handle(uint64_t handle)
+    {
+        (*get_jump()->timemory_push_region_handle_jump)(handle);
+    }
+
+    void timemory_pop_region_handle(uint64_t handle)
+    {
+        (*get_jump()->timemory_pop_region_handle_jump)(handle);
+    }
+
+    void timemory_begin_records(int n, const char** names, uint64_t* ids)
+    {
+        (*get_jump()->timemory_begin_records_jump)(n, names, ids);
+    }
+
+    void timemory_end_records(int n, const uint64_t* ids)
+    {
+        (*get_jump()->timemory_end_records_jump)(n, ids);
+    }
+
     void timemory_add_hash_id(uint64_t hash, const char* name)
     {
         (*get_jump()->timemory_add_hash_id_jump)(hash, name);
@@ -199,4 +255,30 @@ extern "C"
     {
         (*get_jump()->timemory_trace_set_mpi_jump)(a, b);
     }
+
+    //----------------------------------------------------------------------------------//
+    //
+    //      fortran symbols
+    //
+    //----------------------------------------------------------------------------------//
+
+    uint64_t timemory_register_region_(const char* name)
+    {
+        return timemory_register_region(name);
+    }
+
+    uint64_t timemory_register_region_types_(const char* name, const char* types)
+    {
+        return timemory_register_region_types(name, types);
+    }
+
+    void timemory_push_region_handle_(uint64_t handle)
+    {
+        timemory_push_region_handle(handle);
+    }
+
+    void timemory_pop_region_handle_(uint64_t handle)
+    {
+        timemory_pop_region_handle(handle);
+    }
 }
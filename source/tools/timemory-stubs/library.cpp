@@ -76,6 +76,8 @@ extern "C"
     void     timemory_finalize_library(void) {}
     void     timemory_pause(void) {}
     void     timemory_resume(void) {}
+    uint64_t timemory_get_memory_usage(void) { return 0; }
+    uint64_t timemory_get_component_memory_usage(int) { return 0; }
     void     timemory_set_default(const char*) {}
     void     timemory_add_components(const char*) {}
     void     timemory_remove_components(const char*) {}
@@ -92,8 +94,17 @@ extern "C"
     }
     uint64_t timemory_get_begin_record_enum(const char*, ...) { RETURN_MAX(uint64_t); }
     void     timemory_end_record(uint64_t) {}
+    void     timemory_begin_records(int, const char**, uint64_t*) {}
+    void     timemory_end_records(int, const uint64_t*) {}
     void     timemory_push_region(const char*) {}
     void     timemory_pop_region(const char*) {}
+    uint64_t timemory_register_region(const char*) { RETURN_MAX(uint64_t); }
+    uint64_t timemory_register_region_types(const char*, const char*)
+    {
+        RETURN_MAX(uint64_t);
+    }
+    void timemory_push_region_handle(uint64_t) {}
+    void timemory_pop_region_handle(uint64_t) {}
 
     bool timemory_is_throttled(const char*) { return true; }
     void timemory_add_hash_id(uint64_t, const char*) {}
@@ -124,7 +135,16 @@ extern "C"
         RETURN_MAX(uint64_t);
     }
     void timemory_end_record_(uint64_t) {}
+    void timemory_begin_records_(int, const char**, uint64_t*) {}
+    void timemory_end_records_(int, const uint64_t*) {}
     void timemory_push_region_(const char*) {}
     void timemory_pop_region_(const char*) {}
+    uint64_t timemory_register_region_(const char*) { RETURN_MAX(uint64_t); }
+    uint64_t timemory_register_region_types_(const char*, const char*)
+    {
+        RETURN_MAX(uint64_t);
+    }
+    void timemory_push_region_handle_(uint64_t) {}
+    void timemory_pop_region_handle_(uint64_t) {}
 
 }  // extern "C"
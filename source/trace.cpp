@@ -24,6 +24,7 @@
 
 #include "timemory/trace.hpp"
 #include "timemory/compat/library.h"
+#include "timemory/ert/aligned_allocator.hpp"
 #include "timemory/library.h"
 #include "timemory/runtime/configure.hpp"
 #include "timemory/timemory.hpp"
@@ -33,60 +34,308 @@
 #    include "timemory/backends/types/mpi/extern.hpp"
 #endif
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdlib>
-#include <deque>
+#include <iomanip>
 #include <iostream>
-#include <unordered_map>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
 
 using namespace tim::component;
 
-using string_t       = std::string;
-using overhead_map_t = std::unordered_map<size_t, std::pair<wall_clock, size_t>>;
-using throttle_set_t = std::set<size_t>;
-using traceset_t     = tim::component_bundle<TIMEMORY_API, user_trace_bundle>;
-using trace_map_t    = std::unordered_map<size_t, std::deque<traceset_t>>;
+using string_t   = std::string;
+using traceset_t = tim::component_bundle<TIMEMORY_API, user_trace_bundle>;
+
+/// the alignment of the entries in the per-thread table
+static constexpr size_t trace_entry_alignment = 64;
+
+//--------------------------------------------------------------------------------------//
+/// the per-thread state of a traced function. The stack of bundles is reused so, after
+/// the deepest recursion has been reached, a push/pop does not allocate. The overhead
+/// members are the runtime of the function and, in the adaptive mode, the time spent in
+/// the instrumentation over the measured calls since the last throttle evaluation. Each
+/// entry occupies its own cache line so the entries of different functions in the table
+/// do not share one
+///
+struct alignas(trace_entry_alignment) trace_entry
+{
+    uint32_t                                 depth          = 0;
+    uint32_t                                 count          = 0;
+    tim::trace::throttle                     throttle       = {};
+    int64_t                                  overhead_start = 0;
+    int64_t                                  overhead_accum = 0;
+    int64_t                                  overhead_instr = 0;
+    std::vector<std::unique_ptr<traceset_t>> stack          = {};
+};
+
+static_assert(sizeof(trace_entry) == trace_entry_alignment,
+              "trace_entry should fill exactly one cache line");
+
+/// the adaptive throttling of the functions aggregated over all threads
+struct throttle_report
+{
+    uint64_t id          = 0;
+    uint32_t period      = 1;
+    uint32_t max_period  = 1;
+    uint64_t unmeasured  = 0;
+    int64_t  avoided     = 0;
+    uint64_t unthrottled = 0;
+};
+
+/// maps a hash id to a dense index into the per-thread tables
+using trace_index_map_t = tim::concurrent_hash_map<uint64_t, size_t>;
+using trace_allocator_t = tim::ert::aligned_allocator<trace_entry, trace_entry_alignment>;
+using trace_table_t     = std::vector<trace_entry, trace_allocator_t>;
+using throttle_report_t = std::map<size_t, throttle_report>;
 
 //======================================================================================//
 
 static std::atomic<uint32_t> library_trace_count{ 0 };
 
+static constexpr size_t trace_npos = std::numeric_limits<size_t>::max();
+
+//--------------------------------------------------------------------------------------//
+
+static trace_index_map_t&
+get_trace_indexes() TIMEMORY_VISIBILITY("default");
+static trace_table_t&
+get_trace_table() TIMEMORY_VISIBILITY("default");
+
 //--------------------------------------------------------------------------------------//
 
-static auto&
-get_overhead() TIMEMORY_VISIBILITY("default");
-static auto&
-get_throttle() TIMEMORY_VISIBILITY("default");
-static trace_map_t&
-get_trace_map() TIMEMORY_VISIBILITY("default");
+static trace_index_map_t&
+get_trace_indexes()
+{
+    // not destroyed so functions traced during the static destruction are handled
+    static auto* _instance = new trace_index_map_t{};
+    return *_instance;
+}
 
 //--------------------------------------------------------------------------------------//
 
-static auto&
-get_overhead()
+static trace_table_t&
+get_trace_table()
 {
-    static thread_local auto _instance = std::make_unique<overhead_map_t>();
+    static thread_local trace_table_t _instance;
     return _instance;
 }
 
 //--------------------------------------------------------------------------------------//
+// returns the dense index of the hash id, assigning one the first time a registered id
+// is seen. Ids which are aliases of a label share the index of the label. Returns
+// trace_npos if the id is not registered
+//
+static size_t
+get_trace_index(uint64_t _id)
+{
+    auto& _indexes = get_trace_indexes();
+    auto  itr      = _indexes.find(_id);
+    if(itr != _indexes.end())
+        return itr->second;
+
+    auto _hash = tim::get_hash_id(tim::get_hash_aliases(), _id);
+    if(_hash != _id && tim::get_hash_ids()->find(_hash) != tim::get_hash_ids()->end())
+        return _indexes.emplace(_id, get_trace_index(_hash)).first->second;
+
+    if(tim::get_hash_ids()->find(_id) == tim::get_hash_ids()->end())
+        return trace_npos;
+
+    // a concurrent first sight of the same id may leave an unused index
+    static std::atomic<size_t> _count{ 0 };
+    return _indexes.emplace(_id, _count++).first->second;
+}
+
+//--------------------------------------------------------------------------------------//
+// the instrumentation time of the thread since its first traced call, it is created
+// with the first entry of the thread
+//
+struct thread_overhead
+{
+    int64_t begin = wall_clock::record();
+    int64_t instr = 0;
+};
 
-static auto&
-get_throttle()
+static thread_overhead&
+get_thread_overhead()
 {
-    static thread_local auto _instance = std::make_unique<throttle_set_t>();
+    static thread_local thread_overhead _instance{};
     return _instance;
 }
 
 //--------------------------------------------------------------------------------------//
+// the entry of this thread, the table is resized when an index is first seen by the
+// thread
+//
+static trace_entry&
+get_trace_entry(size_t _idx)
+{
+    auto& _table = get_trace_table();
+    if(_idx >= _table.size())
+    {
+        if(_table.empty())
+            get_thread_overhead();
+        _table.resize(_idx + 1);
+    }
+    return _table[_idx];
+}
+
+//--------------------------------------------------------------------------------------//
+// returns nullptr if the name has not been traced
+//
+static trace_entry*
+find_trace_entry(const char* name)
+{
+    auto itr = get_trace_indexes().find(tim::get_hash_id(name));
+    if(itr == get_trace_indexes().end())
+        return nullptr;
+    return &get_trace_entry(itr->second);
+}
+
+//--------------------------------------------------------------------------------------//
+// the throttle settings are read when the tracing is configured so the mode is not
+// looked up on every call
+//
+struct throttle_config : tim::trace::throttle::config
+{
+    bool     adaptive = false;
+    uint32_t window   = 100;
+};
 
-static trace_map_t&
-get_trace_map()
+static throttle_config&
+get_throttle_config()
 {
-    static thread_local trace_map_t _instance;
+    static throttle_config _instance{};
     return _instance;
 }
 
+static void
+configure_throttle()
+{
+    auto& _cfg      = get_throttle_config();
+    _cfg.adaptive   = tim::settings::adaptive_throttle();
+    _cfg.value      = tim::settings::throttle_value();
+    _cfg.budget     = tim::settings::throttle_budget();
+    _cfg.max_period = std::min<size_t>(tim::settings::throttle_max_period(),
+                                       std::numeric_limits<uint32_t>::max());
+    _cfg.window     = std::max<size_t>(
+        std::min<size_t>(tim::settings::throttle_count(), _cfg.window), 1);
+}
+
+//--------------------------------------------------------------------------------------//
+
+static std::pair<std::mutex, throttle_report_t>&
+get_throttle_report()
+{
+    static auto* _instance = new std::pair<std::mutex, throttle_report_t>{};
+    return *_instance;
+}
+
+//--------------------------------------------------------------------------------------//
+// invoked after a window of measured calls in the adaptive mode
+//
+static void
+update_throttle(uint64_t _id, size_t _idx, trace_entry& _entry)
+{
+    const auto& _cfg = get_throttle_config();
+    auto&       _thr = get_thread_overhead();
+
+    _thr.instr += _entry.overhead_instr;
+    auto   _elapsed  = wall_clock::record() - _thr.begin;
+    double _overhead = (_elapsed > 0) ? (_thr.instr / static_cast<double>(_elapsed)) : 0.;
+    uint64_t _runtime = _entry.overhead_accum / _entry.count;
+    int64_t  _instr   = _entry.overhead_instr / _entry.count;
+
+    auto _prev   = _entry.throttle.update(_cfg, _runtime, _overhead);
+    auto _period = _entry.throttle.period;
+
+    // approximately period - 1 calls were not measured for every measured call
+    uint64_t _unmeasured = _entry.count * static_cast<uint64_t>(_prev - 1);
+
+    _entry.count          = 0;
+    _entry.overhead_accum = 0;
+    _entry.overhead_instr = 0;
+
+    if(_prev == 1 && _period == 1)
+        return;
+
+    {
+        auto&                       _report = get_throttle_report();
+        std::lock_guard<std::mutex> _lk{ _report.first };
+        auto&                       _v = _report.second[_idx];
+        _v.id                          = _id;
+        _v.period                      = _period;
+        _v.max_period                  = std::max(_v.max_period, _period);
+        _v.unmeasured += _unmeasured;
+        _v.avoided += _unmeasured * _instr;
+        if(_period == 1)
+            ++_v.unthrottled;
+    }
+
+    if((_prev == 1 || _period == 1) &&
+       (tim::settings::debug() || tim::settings::verbose() > 0))
+    {
+        auto _name = tim::get_hash_identifier(_id);
+        if(_period > 1)
+        {
+            fprintf(stderr,
+                    "[timemory-trace]> Measuring one in %u calls to '%s' on thread %i. "
+                    "avg runtime = %lu ns, instrumentation = %.2f%% of the runtime...\n",
+                    _period, _name.c_str(), (int) tim::threading::get_id(),
+                    (unsigned long) _runtime, 100. * _overhead);
+        }
+        else
+        {
+            fprintf(stderr,
+                    "[timemory-trace]> Measuring every call to '%s' on thread %i again. "
+                    "avg runtime = %lu ns...\n",
+                    _name.c_str(), (int) tim::threading::get_id(),
+                    (unsigned long) _runtime);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+static void
+print_throttle_report()
+{
+    auto&                       _report = get_throttle_report();
+    std::lock_guard<std::mutex> _lk{ _report.first };
+    if(_report.second.empty() || tim::settings::verbose() < 0)
+        return;
+
+    uint64_t _unmeasured = 0;
+    int64_t  _avoided    = 0;
+    for(const auto& itr : _report.second)
+    {
+        _unmeasured += itr.second.unmeasured;
+        _avoided += itr.second.avoided;
+    }
+
+    std::stringstream _ss;
+    _ss << "[timemory-trace]> adaptive throttling of " << _report.second.size()
+        << " functions: ~" << _unmeasured << " calls were not measured, an estimated "
+        << std::setprecision(3) << std::fixed << (_avoided * 1.0e-6)
+        << " ms of instrumentation overhead was avoided\n";
+    for(const auto& itr : _report.second)
+    {
+        const auto& _v = itr.second;
+        _ss << "    " << tim::get_hash_identifier(_v.id) << " : one in " << _v.period
+            << " calls measured (max " << _v.max_period << "), ~" << _v.unmeasured
+            << " calls not measured, ~" << (_v.avoided * 1.0e-6) << " ms avoided";
+        if(_v.unthrottled > 0)
+            _ss << ", un-throttled " << _v.unthrottled << " times";
+        _ss << "\n";
+    }
+    fprintf(stderr, "%s", _ss.str().c_str());
+    _report.second.clear();
+}
+
 //--------------------------------------------------------------------------------------//
 
 extern std::array<bool, 2>&
@@ -332,7 +581,6 @@ setup_mpi_gotcha()
 
 static bool                                mpi_gotcha_configured = setup_mpi_gotcha();
 static std::shared_ptr<mpi_trace_bundle_t> mpi_gotcha_handle{ nullptr };
-static std::map<size_t, string_t>          master_hash_ids;
 
 //--------------------------------------------------------------------------------------//
 //
@@ -355,18 +603,17 @@ extern "C"
     //
     bool timemory_is_throttled(const char* name)
     {
-        size_t _id = tim::get_hash_id(name);
-        return (get_throttle()->count(_id) > 0);
+        auto* _entry = find_trace_entry(name);
+        return (_entry && _entry->throttle.is_throttled());
     }
     //
     //----------------------------------------------------------------------------------//
     //
     void timemory_reset_throttle(const char* name)
     {
-        size_t _id = tim::get_hash_id(name);
-        auto   itr = get_throttle()->find(_id);
-        if(itr != get_throttle()->end())
-            get_throttle()->erase(itr);
+        auto* _entry = find_trace_entry(name);
+        if(_entry)
+            _entry->throttle.reset();
     }
     //
     //----------------------------------------------------------------------------------//
@@ -386,14 +633,11 @@ extern "C"
                     (unsigned long) id);
         auto _id = tim::add_hash_id(name);
         if(_id != id)
-            tim::add_hash_id(_id, id);
-
-        // master thread adds the ids
-        if(tim::threading::get_id() == 0)
         {
-            master_hash_ids[id] = name;
-            if(_id != id)
-                master_hash_ids[_id] = name;
+            // the id was generated with a different hash function so register the
+            // label under the id in addition to the alias
+            tim::get_hash_ids()->emplace(id, name);
+            tim::add_hash_id(_id, id);
         }
     }
     //
@@ -410,31 +654,11 @@ extern "C"
     //
     //----------------------------------------------------------------------------------//
     //
-    void timemory_copy_hash_ids()
-    {
-        tim::trace::lock<tim::trace::library> lk{};
-        static thread_local bool              once_per_thread = false;
-        if(!once_per_thread && tim::threading::get_id() > 0)
-        {
-            if(tim::settings::debug())
-                fprintf(stderr, "[timemory-trace]> copying hash ids...\n");
-            once_per_thread  = true;
-            auto _master_ids = master_hash_ids;
-            for(const auto& itr : _master_ids)
-                timemory_add_hash_id(itr.first, itr.second.c_str());
-        }
-    }
-    //
-    //----------------------------------------------------------------------------------//
-    //
     void timemory_push_trace_hash(uint64_t id)
     {
         if(!timemory_trace_is_initialized())
             timemory_trace_init("", true, "");
 
-        static thread_local auto _copied = (timemory_copy_hash_ids(), true);
-        tim::consume_parameters(_copied);
-
         tim::trace::lock<tim::trace::library> lk{};
 
         if(!lk)
@@ -458,7 +682,14 @@ extern "C"
             return;
         }
 
-        if(get_throttle()->count(id) > 0)
+        auto _idx = get_trace_index(id);
+        if(_idx == trace_npos)
+            return;
+
+        // a call within a measured call of the same function is always measured so
+        // a pop stops a bundle if and only if the matching push started one
+        auto& _entry = get_trace_entry(_idx);
+        if(_entry.depth == 0 && !_entry.throttle.sample())
         {
 #if defined(DEBUG) || !defined(NDEBUG)
             if(tim::settings::debug())
@@ -467,15 +698,9 @@ extern "C"
             return;
         }
 
-        auto& _trace_map = get_trace_map();
-        auto& _overh_map = *get_overhead();
-
-        if(tim::get_hash_ids()->find(id) == tim::get_hash_ids()->end())
-            return;
-
         if(tim::settings::debug())
         {
-            int64_t  n    = _trace_map[id].size();
+            int64_t  n    = _entry.depth;
             auto     itr  = tim::get_hash_ids()->find(id);
             string_t name = (itr != tim::get_hash_ids()->end()) ? itr->second : "unknown";
             fprintf(stderr,
@@ -486,9 +711,13 @@ extern "C"
                     (int) tim::threading::get_id());
         }
 
-        _trace_map[id].emplace_back(traceset_t{ id });
-        _trace_map[id].back().start();
-        _overh_map[id].first.start();
+        int64_t _beg = (get_throttle_config().adaptive) ? wall_clock::record() : 0;
+        if(_entry.depth == _entry.stack.size())
+            _entry.stack.emplace_back(std::make_unique<traceset_t>(id));
+        _entry.stack[_entry.depth++]->start();
+        _entry.overhead_start = wall_clock::record();
+        if(_beg > 0)
+            _entry.overhead_instr += _entry.overhead_start - _beg;
     }
     //
     //----------------------------------------------------------------------------------//
@@ -499,19 +728,23 @@ extern "C"
         if(!get_library_state()[0] || get_library_state()[1])
             return;
 
-        auto& _trace_map = get_trace_map();
-        if(!tim::settings::enabled() && _trace_map.empty())
+        auto& _trace_table = get_trace_table();
+        if(!tim::settings::enabled() && _trace_table.empty())
         {
-            if(tim::settings::debug() && _trace_map.empty())
+            if(tim::settings::debug() && _trace_table.empty())
                 fprintf(stderr,
                         "[timemory-trace]> timemory_pop_trace_hash(%lu) failed. "
-                        "trace_map empty...\n",
+                        "trace table empty...\n",
                         (unsigned long) id);
             return;
         }
 
-        int64_t ntotal = _trace_map[id].size();
-        int64_t offset = ntotal - 1;
+        auto _idx = get_trace_index(id);
+        if(_idx == trace_npos)
+            return;
+
+        auto&   _entry = get_trace_entry(_idx);
+        int64_t offset = static_cast<int64_t>(_entry.depth) - 1;
 
         if(tim::settings::debug())
         {
@@ -525,26 +758,42 @@ extern "C"
                     (int) tim::threading::get_id());
         }
 
-        (*get_overhead())[id].first.stop();
+        int64_t _end = 0;
+        if(_entry.overhead_start > 0)
+        {
+            _end = wall_clock::record();
+            _entry.overhead_accum += _end - _entry.overhead_start;
+            _entry.overhead_start = 0;
+        }
 
-        // if there were no entries, return (pop called without a push)
+        // if there were no entries, return (pop called without a push or the push was
+        // not measured)
         if(offset < 0)
             return;
 
-        if(offset >= 0 && ntotal > 0)
-        {
-            _trace_map[id].back().stop();
-            _trace_map[id].pop_back();
-        }
+        _entry.stack[--_entry.depth]->stop();
 
-        if(get_throttle() && get_throttle()->count(id) > 0)
+        if(_entry.throttle.period == 0)
             return;
 
-        auto _count = ++(get_overhead()->at(id).second);
+        const auto& _cfg = get_throttle_config();
+        if(_cfg.adaptive)
+        {
+            if(_end > 0)
+                _entry.overhead_instr += wall_clock::record() - _end;
+            if(++_entry.count >= _cfg.window)
+                update_throttle(id, _idx, _entry);
+            return;
+        }
+
+        auto _count = ++_entry.count;
 
-        if(_count % tim::settings::throttle_count() == 0)
+        if(_count >= tim::settings::throttle_count())
         {
-            auto _accum = get_overhead()->at(id).first.get_accum() / _count;
+            uint64_t _accum =
+                (_entry.overhead_accum > 0)
+                    ? static_cast<uint64_t>(_entry.overhead_accum) / _count
+                    : 0;
             if(_accum < tim::settings::throttle_value())
             {
                 if(tim::settings::debug() || tim::settings::verbose() > 0)
@@ -560,7 +809,7 @@ extern "C"
                         (int) tim::threading::get_id(), (unsigned long) _accum,
                         (unsigned long) _count);
                 }
-                get_throttle()->insert(id);
+                _entry.throttle.disable();
             }
             else
             {
@@ -580,8 +829,8 @@ extern "C"
                         (unsigned long) _count);
                 }
             }
-            get_overhead()->at(id).first.reset();
-            get_overhead()->at(id).second = 0;
+            _entry.overhead_accum = 0;
+            _entry.count          = 0;
         }
     }
     //
@@ -645,6 +894,7 @@ extern "C"
         {
             tim::settings::parse();
             user_trace_bundle::global_init();
+            configure_throttle();
         }
     }
     //
@@ -723,6 +973,7 @@ extern "C"
             }
 
             tim::settings::parse();
+            configure_throttle();
 
             // configure bundle
             user_trace_bundle::global_init();
@@ -827,17 +1078,18 @@ extern "C"
         // clean up any remaining entries
         if(!_skip_stop)
         {
-            for(auto& itr : get_trace_map())
+            for(auto& itr : get_trace_table())
             {
-                for(auto& eitr : itr.second)
-                    eitr.stop();
-                // delete all the records
-                itr.second.clear();
+                for(uint32_t i = 0; i < itr.depth; ++i)
+                    itr.stack[i]->stop();
+                itr.depth = 0;
             }
         }
 
         // delete all the records
-        get_trace_map().clear();
+        get_trace_table().clear();
+
+        print_throttle_report();
 
         // deactivate the gotcha wrappers
         if(use_mpi_gotcha)
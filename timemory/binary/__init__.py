@@ -0,0 +1,227 @@
+#!@PYTHON_EXECUTABLE@
+#
+# MIT License
+#
+# Copyright (c) 2018, The Regents of the University of California,
+# through Lawrence Berkeley National Laboratory (subject to receipt of any
+# required approvals from the U.S. Dept. of Energy).  All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+from __future__ import absolute_import
+
+__author__ = "Jonathan Madsen"
+__copyright__ = "Copyright 2020, The Regents of the University of California"
+__credits__ = ["Jonathan Madsen"]
+__license__ = "MIT"
+__version__ = "@PROJECT_VERSION@"
+__maintainer__ = "Jonathan Madsen"
+__email__ = "jrmadsen@lbl.gov"
+__status__ = "Development"
+
+"""
+This submodule reads the binary output of the components
+(TIMEMORY_BINARY_OUTPUT) without the timemory library and converts it to JSON
+
+    import timemory.binary
+
+    data = timemory.binary.load("timemory-output/wall.bin")
+    for node in data["timemory"]["wall"]["ranks"][0]["graph"]:
+        print("{} : {}".format(node["prefix"], node["entry"]["repr_data"]))
+
+    timemory.binary.to_json("timemory-output/wall.bin")
+"""
+
+import json
+import mmap
+import struct
+
+__all__ = ["reader", "load", "to_json"]
+
+MAGIC = b"TIMGRAPH"
+VERSION = 1
+ENDIAN_TAG = 0x01020304
+
+_file_header = "8sIIIIQ"
+_node_header = "QqQHHI"
+
+
+class reader(object):
+    """Reads the header and the metadata of the file when it is opened and
+    yields the nodes in pre-order, one at a time, from :meth:`nodes`
+    """
+
+    def __init__(self, filename):
+        self.filename = filename
+        self._file = open(filename, "rb")
+        try:
+            self._read_header()
+        except Exception:
+            self._file.close()
+            raise
+
+    def close(self):
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def _read(self, n):
+        data = self._file.read(n)
+        if len(data) != n:
+            raise EOFError("'{}' is truncated".format(self.filename))
+        return data
+
+    def _unpack(self, fmt):
+        return struct.unpack(
+            self._order + fmt, self._read(struct.calcsize(fmt))
+        )
+
+    def _read_string(self):
+        (n,) = self._unpack("I")
+        return self._read(n).decode("utf-8", errors="replace")
+
+    def _read_header(self):
+        data = self._read(struct.calcsize("<" + _file_header))
+        # the endian tag is written in the byte order of the writer
+        for order in ("<", ">"):
+            fields = struct.unpack(order + _file_header, data)
+            if fields[0] != MAGIC:
+                raise ValueError(
+                    "'{}' is not a timemory binary output".format(self.filename)
+                )
+            if fields[2] == ENDIAN_TAG:
+                self._order = order
+                break
+        else:
+            raise ValueError(
+                "'{}' has an invalid endian tag".format(self.filename)
+            )
+
+        _, version, _, value_size, nvalues, nranks = fields
+        if version != VERSION:
+            raise ValueError(
+                "'{}' has an unsupported version ({})".format(
+                    self.filename, version
+                )
+            )
+        if value_size != 8:
+            raise ValueError("'{}' is corrupted".format(self.filename))
+
+        self.version = version
+        self.nvalues = nvalues
+        self.nranks = nranks
+        self.label = self._read_string()
+        self.description = self._read_string()
+        self.unit = self._read_string()
+        (self.concurrency,) = self._unpack("q")
+
+    def nodes(self):
+        """Yields a dictionary for each node with the rank, hash, prefix, depth,
+        tid, pid, laps and the list of values. The file is memory-mapped so only
+        the pages of the nodes which are being read are loaded
+        """
+        node_header = struct.Struct(self._order + _node_header)
+        values = struct.Struct("{}{}d".format(self._order, self.nvalues))
+        rank_header = struct.Struct(self._order + "QQ")
+        offset = self._file.tell()
+        with mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ) as data:
+            size = len(data)
+            for _ in range(self.nranks):
+                if offset + rank_header.size > size:
+                    raise EOFError("'{}' is truncated".format(self.filename))
+                rank, nnodes = rank_header.unpack_from(data, offset)
+                offset += rank_header.size
+                for _ in range(nnodes):
+                    if offset + node_header.size > size:
+                        raise EOFError(
+                            "'{}' is truncated".format(self.filename)
+                        )
+                    hash_id, depth, laps, tid, pid, length = (
+                        node_header.unpack_from(data, offset)
+                    )
+                    offset += node_header.size
+                    prefix = data[offset : offset + length]
+                    offset += length
+                    if offset + values.size > size:
+                        raise EOFError(
+                            "'{}' is truncated".format(self.filename)
+                        )
+                    yield {
+                        "rank": rank,
+                        "hash": hash_id,
+                        "prefix": prefix.decode("utf-8", errors="replace"),
+                        "depth": depth,
+                        "tid": tid,
+                        "pid": pid,
+                        "laps": laps,
+                        "values": list(values.unpack_from(data, offset)),
+                    }
+                    offset += values.size
+
+
+def _entry(node, nvalues):
+    value = node["values"][0] if nvalues == 1 else node["values"]
+    return {
+        "hash": node["hash"],
+        "prefix": node["prefix"],
+        "depth": node["depth"],
+        "tid": node["tid"],
+        "pid": node["pid"],
+        "entry": {"laps": node["laps"], "repr_data": value},
+    }
+
+
+def load(filename):
+    """Returns the contents of the file in the same hierarchy as the JSON output
+    of the component: timemory -> <label> -> ranks -> graph
+    """
+    with reader(filename) as r:
+        ranks = []
+        for node in r.nodes():
+            if not ranks or ranks[-1]["rank"] != node["rank"]:
+                ranks.append({"rank": node["rank"], "graph": []})
+            ranks[-1]["graph"].append(_entry(node, r.nvalues))
+        return {
+            "timemory": {
+                r.label: {
+                    "num_ranks": r.nranks,
+                    "concurrency": r.concurrency,
+                    "type": r.label,
+                    "description": r.description,
+                    "unit_repr": r.unit,
+                    "ranks": ranks,
+                }
+            }
+        }
+
+
+def to_json(filename, output=None, indent=None):
+    """Converts the binary output into JSON. When the output is not provided,
+    '.json' is appended to the name of the input file so that the JSON output of
+    the component is not replaced. Returns the name of the output file
+    """
+    if output is None:
+        output = filename + ".json"
+    with open(output, "w") as f:
+        json.dump(load(filename), f, indent=indent)
+    return output
@@ -0,0 +1,77 @@
+#!@PYTHON_EXECUTABLE@
+#
+# MIT License
+#
+# Copyright (c) 2018, The Regents of the University of California,
+# through Lawrence Berkeley National Laboratory (subject to receipt of any
+# required approvals from the U.S. Dept. of Energy).  All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+from __future__ import absolute_import
+
+""" @file __main__.py
+Command line conversion of the binary output to JSON
+"""
+
+import sys
+import argparse
+
+from . import to_json
+
+
+def main(args=None):
+    """Converts each binary output file to JSON"""
+
+    parser = argparse.ArgumentParser(
+        description="Convert the binary output of timemory components to JSON"
+    )
+    parser.add_argument("files", nargs="+", help="Binary output files")
+    parser.add_argument(
+        "-o",
+        "--output",
+        nargs="+",
+        default=None,
+        help="Output file for each input file (default: <input>.json)",
+    )
+    parser.add_argument(
+        "-i",
+        "--indent",
+        type=int,
+        default=None,
+        help="Indentation of the JSON output",
+    )
+
+    args = parser.parse_args(args)
+    if args.output is not None and len(args.output) != len(args.files):
+        parser.error(
+            "the number of output files must match the number of input files"
+        )
+
+    for i, fname in enumerate(args.files):
+        output = args.output[i] if args.output is not None else None
+        print(
+            "[timemory]> Outputting '{}'...".format(
+                to_json(fname, output, args.indent)
+            )
+        )
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
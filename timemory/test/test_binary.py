@@ -0,0 +1,172 @@
+#!@PYTHON_EXECUTABLE@
+# MIT License
+#
+# Copyright (c) 2018, The Regents of the University of California,
+# through Lawrence Berkeley National Laboratory (subject to receipt of any
+# required approvals from the U.S. Dept. of Energy).  All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+
+from __future__ import absolute_import
+
+__author__ = "Jonathan Madsen"
+__copyright__ = "Copyright 2020, The Regents of the University of California"
+__credits__ = ["Jonathan Madsen"]
+__license__ = "MIT"
+__version__ = "@PROJECT_VERSION@"
+__maintainer__ = "Jonathan Madsen"
+__email__ = "jrmadsen@lbl.gov"
+__status__ = "Development"
+
+import os
+import sys
+import glob
+import json
+import shutil
+import tempfile
+import unittest
+import subprocess
+import timemory as tim
+import timemory.binary
+
+# --------------------------- test setup variables ----------------------------------- #
+
+# the binary output is written when timemory is finalized so the measurements are
+# done in a separate process. The JSON of the storage is dumped right before
+# finalization so that the values read back from the binary file can be compared
+_measure = """
+import json
+import time
+import timemory as tim
+from timemory.bundle import marker
+
+tim.settings.binary_output = True
+tim.settings.json_output = False
+tim.settings.text_output = False
+tim.settings.cout_output = False
+tim.settings.flamegraph_output = False
+tim.settings.dart_output = False
+tim.settings.banner = False
+tim.settings.output_path = "{output_path}"
+
+with marker(components=["wall_clock"], key="outer"):
+    for i in range({ninner}):
+        with marker(components=["wall_clock"], key="inner"):
+            time.sleep(1.0e-3)
+
+with open("{json_output}", "w") as f:
+    json.dump(tim.get()["timemory"]["wall_clock"], f)
+
+tim.finalize()
+"""
+
+# -------------------------- Binary Tests set ---------------------------------------- #
+# Binary tests class
+class TimemoryBinaryTests(unittest.TestCase):
+    # setup class: write the binary output
+    @classmethod
+    def setUpClass(self):
+        self.ninner = 5
+        self.output_path = tempfile.mkdtemp(prefix="timemory-binary-")
+        self.json_output = os.path.join(self.output_path, "storage.json")
+        subprocess.check_call(
+            [
+                sys.executable,
+                "-c",
+                _measure.format(
+                    output_path=self.output_path,
+                    json_output=self.json_output,
+                    ninner=self.ninner,
+                ),
+            ]
+        )
+        with open(self.json_output, "r") as f:
+            self.storage = json.load(f)
+        self.graph = self.storage["ranks"][0]["graph"]
+        self.filename = glob.glob(os.path.join(self.output_path, "*wall.bin"))[0]
+
+    # tear down class: remove the output
+    @classmethod
+    def tearDownClass(self):
+        shutil.rmtree(self.output_path, ignore_errors=True)
+
+    # ---------------------------------------------------------------------------------- #
+    # test the header
+    def test_header(self):
+        """header"""
+        with timemory.binary.reader(self.filename) as r:
+            self.assertEqual(r.label, "wall")
+            self.assertEqual(r.nvalues, 1)
+            self.assertEqual(r.nranks, 1)
+            self.assertEqual(r.unit, self.storage["unit_repr"])
+
+    # ---------------------------------------------------------------------------------- #
+    # test the values read back against the storage
+    def test_nodes(self):
+        """nodes"""
+        with timemory.binary.reader(self.filename) as r:
+            nodes = list(r.nodes())
+
+        self.assertEqual(len(nodes), len(self.graph))
+        self.assertEqual(len(nodes), 2)
+
+        for node, entry in zip(nodes, self.graph):
+            self.assertEqual(node["hash"], entry["hash"])
+            self.assertEqual(node["prefix"], entry["prefix"])
+            self.assertEqual(node["depth"], entry["depth"])
+            self.assertEqual(node["laps"], entry["entry"]["laps"])
+            self.assertAlmostEqual(
+                node["values"][0], entry["entry"]["repr_data"], places=9
+            )
+
+        self.assertTrue(nodes[0]["prefix"].endswith("outer"))
+        self.assertTrue(nodes[1]["prefix"].endswith("inner"))
+        self.assertEqual(nodes[0]["laps"], 1)
+        self.assertEqual(nodes[1]["laps"], self.ninner)
+        self.assertGreaterEqual(nodes[1]["values"][0], self.ninner * 1.0e-3)
+        self.assertGreaterEqual(nodes[0]["values"][0], nodes[1]["values"][0])
+
+    # ---------------------------------------------------------------------------------- #
+    # test the conversion to the JSON hierarchy of the component
+    def test_load(self):
+        """load"""
+        data = timemory.binary.load(self.filename)["timemory"]["wall"]
+        graph = data["ranks"][0]["graph"]
+
+        self.assertEqual(data["num_ranks"], 1)
+        self.assertEqual(len(graph), len(self.graph))
+        for node, entry in zip(graph, self.graph):
+            self.assertEqual(node["prefix"], entry["prefix"])
+            self.assertEqual(node["entry"]["laps"], entry["entry"]["laps"])
+            self.assertAlmostEqual(
+                node["entry"]["repr_data"], entry["entry"]["repr_data"], places=9
+            )
+
+
+# ----------------------------- main test runner ---------------------------------------- #
+# main runner
+def run():
+    # run all tests
+    unittest.main()
+
+
+if __name__ == "__main__":
+    tim.initialize([__file__])
+    run()